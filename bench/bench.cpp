@@ -0,0 +1,981 @@
+// Multi-threaded scaling benchmark for Mustex and raw standard mutexes.
+//
+// Every configuration of the sweep (engine x threads x write ratio x critical section x payload)
+// runs for a fixed amount of time, and reports the throughput along with acquire latency
+// percentiles. Run with --help for the list of options.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <mustex/adaptive_mutex.hpp>
+#include <mustex/cohort_mutex.hpp>
+#include <mustex/combining_mustex.hpp>
+#include <mustex/distributed_shared_mutex.hpp>
+#include <mustex/left_right_mustex.hpp>
+#include <mustex/mcs_mutex.hpp>
+#include <mustex/parking_lot_mutex.hpp>
+#include <mustex/pi_mutex.hpp>
+#include <mustex/mustex.hpp>
+#include <mustex/ranked_mutex.hpp>
+#include <mustex/rcu_mustex.hpp>
+#include <mustex/seq_mustex.hpp>
+#include <mustex/wait_strategy.hpp>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+using Clock = std::chrono::steady_clock;
+
+/// @brief Log-linear histogram of nanosecond latencies, in the spirit of HdrHistogram.
+/// Values below 64 are exact, larger values are recorded with a relative precision of ~3%.
+class LatencyHistogram
+{
+public:
+    LatencyHistogram()
+        : m_counts(BUCKETS, 0)
+        , m_total{0}
+    {
+    }
+
+    void record(uint64_t value, uint64_t count = 1)
+    {
+        m_counts[index_of(value)] += count;
+        m_total += count;
+    }
+
+    /// @brief Record a value measured by a closed-loop thread, correcting coordinated omission.
+    /// A thread stalled for `value` could not issue the requests it would have issued every
+    /// `expected_interval`, so these missing samples (value - interval, value - 2 * interval, ...)
+    /// are back-filled, exactly like HdrHistogram's recordValueWithExpectedInterval().
+    void record_corrected(uint64_t value, uint64_t expected_interval)
+    {
+        record(value);
+        if (expected_interval == 0 || value < 2 * expected_interval)
+            return;
+
+        // Missing samples are value - k * interval for k in [1, k_max], all >= interval.
+        const uint64_t k_max = (value - expected_interval) / expected_interval;
+        const std::size_t first = index_of(value - k_max * expected_interval);
+        const std::size_t last = index_of(value - expected_interval);
+        for (std::size_t i = first; i <= last; ++i)
+        {
+            const uint64_t lo = lowest_of(i);
+            const uint64_t hi = highest_of(i);
+            const uint64_t k_lo = hi >= value ? 1 : std::max<uint64_t>(1, (value - hi + expected_interval - 1) / expected_interval);
+            const uint64_t k_hi = std::min(k_max, (value - lo) / expected_interval);
+            if (k_hi >= k_lo)
+                record(lo, k_hi - k_lo + 1);
+        }
+    }
+
+    void merge(const LatencyHistogram &other)
+    {
+        for (std::size_t i = 0; i < BUCKETS; ++i)
+            m_counts[i] += other.m_counts[i];
+        m_total += other.m_total;
+    }
+
+    void reset()
+    {
+        std::fill(m_counts.begin(), m_counts.end(), 0);
+        m_total = 0;
+    }
+
+    uint64_t total() const { return m_total; }
+
+    /// @brief Highest value below which lies given fraction (in [0, 1]) of recorded values.
+    uint64_t percentile(double fraction) const
+    {
+        if (m_total == 0)
+            return 0;
+        const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(fraction * static_cast<double>(m_total) + 0.5));
+        uint64_t seen = 0;
+        for (std::size_t i = 0; i < BUCKETS; ++i)
+        {
+            seen += m_counts[i];
+            if (seen >= rank)
+                return highest_of(i);
+        }
+        return highest_of(BUCKETS - 1);
+    }
+
+private:
+    static constexpr unsigned SUB_BITS = 5;
+    static constexpr uint64_t SUB_COUNT = uint64_t{1} << SUB_BITS;
+    static constexpr std::size_t BUCKETS = (64 - SUB_BITS) * SUB_COUNT;
+
+    static unsigned msb(uint64_t value)
+    {
+        unsigned r = 0;
+        while (value >>= 1)
+            ++r;
+        return r;
+    }
+
+    static std::size_t index_of(uint64_t value)
+    {
+        if (value < 2 * SUB_COUNT)
+            return static_cast<std::size_t>(value);
+        const unsigned shift = msb(value) - SUB_BITS;
+        return static_cast<std::size_t>((shift + 1) * SUB_COUNT + (value >> shift) - SUB_COUNT);
+    }
+
+    static uint64_t lowest_of(std::size_t index)
+    {
+        if (index < 2 * SUB_COUNT)
+            return index;
+        const unsigned shift = static_cast<unsigned>(index / SUB_COUNT - 1);
+        return (index % SUB_COUNT + SUB_COUNT) << shift;
+    }
+
+    static uint64_t highest_of(std::size_t index)
+    {
+        if (index < 2 * SUB_COUNT)
+            return index;
+        const unsigned shift = static_cast<unsigned>(index / SUB_COUNT - 1);
+        return lowest_of(index) + (uint64_t{1} << shift) - 1;
+    }
+
+    std::vector<uint64_t> m_counts;
+    uint64_t m_total;
+};
+
+constexpr unsigned LatencyHistogram::SUB_BITS;
+constexpr uint64_t LatencyHistogram::SUB_COUNT;
+constexpr std::size_t LatencyHistogram::BUCKETS;
+
+/// @brief Small and fast pseudo-random generator, one per thread.
+class XorShift
+{
+public:
+    explicit XorShift(uint64_t seed)
+        : m_state{seed * 0x9E3779B97F4A7C15ull + 1}
+    {
+    }
+
+    uint64_t next()
+    {
+        m_state ^= m_state << 13;
+        m_state ^= m_state >> 7;
+        m_state ^= m_state << 17;
+        return m_state;
+    }
+
+private:
+    uint64_t m_state;
+};
+
+/// @brief Burn some CPU cycles, the amount of work being proportional to `units`.
+uint64_t busy_work(unsigned units, uint64_t seed)
+{
+    for (unsigned i = 0; i < units; ++i)
+        seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    return seed;
+}
+
+/// @brief Protected data, of configurable size.
+template<std::size_t WORDS>
+using Payload = std::array<uint64_t, WORDS>;
+
+template<class P>
+uint64_t read_payload(const P &payload)
+{
+    uint64_t sum = 0;
+    for (uint64_t word : payload)
+        sum += word;
+    return sum;
+}
+
+template<class P>
+void write_payload(P &payload)
+{
+    for (uint64_t &word : payload)
+        ++word;
+}
+
+struct Config
+{
+    unsigned threads;
+    unsigned write_percent;
+    unsigned cs_units;
+    unsigned think_units;
+    std::size_t payload_bytes;
+    std::chrono::milliseconds warmup;
+    std::chrono::milliseconds duration;
+    /// When non zero, each thread issues one operation every interval (open loop).
+    std::chrono::nanoseconds interval;
+};
+
+struct Result
+{
+    double mops;
+    LatencyHistogram latencies;
+};
+
+/// @brief Per-thread state, padded to avoid false sharing between workers.
+struct Worker
+{
+    char padding_front[64];
+    uint64_t ops = 0;
+    uint64_t sink = 0;
+    LatencyHistogram latencies;
+    char padding_back[64];
+};
+
+/// @brief Run given engine with given configuration.
+/// An engine provides `read(F)` and `write(F)`, calling `F(data)` right after acquisition, then
+/// possibly again on other data it protects.
+template<class Engine>
+Result run(const Config &config)
+{
+    Engine engine;
+    std::vector<Worker> workers(config.threads);
+    std::atomic<unsigned> ready{0};
+    std::atomic<int> phase{0}; // 0: wait, 1: warmup, 2: measure, 3: stop
+
+    auto body = [&](unsigned id)
+    {
+        Worker &worker = workers[id];
+        XorShift rng(id + 1);
+        ready.fetch_add(1);
+        while (phase.load(std::memory_order_acquire) == 0)
+            std::this_thread::yield();
+
+        const Clock::time_point warmup_start = Clock::now();
+        uint64_t warmup_ops = 0;
+        uint64_t expected_interval = 0;
+        bool measuring = false;
+        Clock::time_point next_start = warmup_start;
+
+        for (;;)
+        {
+            const int current = phase.load(std::memory_order_relaxed);
+            if (current == 3)
+                break;
+            if (current == 2 && !measuring)
+            {
+                // Closed-loop mean operation time, used to correct coordinated omission.
+                const auto warmup_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - warmup_start).count();
+                expected_interval = warmup_ops ? static_cast<uint64_t>(warmup_ns) / warmup_ops : 0;
+                worker.latencies.reset();
+                measuring = true;
+            }
+
+            Clock::time_point start;
+            if (config.interval.count() > 0)
+            {
+                // Open loop : latency is measured from intended start, hence no omission.
+                while (Clock::now() < next_start)
+                    ;
+                start = next_start;
+                next_start += config.interval;
+            }
+            else
+            {
+                start = Clock::now();
+            }
+
+            // Engines may call F more than once (both replicas, both mutexes...), first call is timed.
+            Clock::time_point acquired;
+            const bool is_write = rng.next() % 100 < config.write_percent;
+            if (is_write)
+            {
+                engine.write(
+                    [&](typename Engine::payload_t &data)
+                    {
+                        if (acquired == Clock::time_point())
+                            acquired = Clock::now();
+                        write_payload(data);
+                        worker.sink += busy_work(config.cs_units, data[0]);
+                    }
+                );
+            }
+            else
+            {
+                engine.read(
+                    [&](const typename Engine::payload_t &data)
+                    {
+                        if (acquired == Clock::time_point())
+                            acquired = Clock::now();
+                        worker.sink += busy_work(config.cs_units, read_payload(data));
+                    }
+                );
+            }
+            worker.sink += busy_work(config.think_units, worker.sink);
+
+            const uint64_t latency = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(acquired - start).count());
+            if (measuring)
+            {
+                ++worker.ops;
+                if (config.interval.count() > 0)
+                    worker.latencies.record(latency);
+                else
+                    worker.latencies.record_corrected(latency, expected_interval);
+            }
+            else
+            {
+                ++warmup_ops;
+            }
+        }
+    };
+
+    std::vector<std::thread> threads;
+    for (unsigned i = 0; i < config.threads; ++i)
+        threads.emplace_back(body, i);
+    while (ready.load() != config.threads)
+        std::this_thread::yield();
+
+    phase.store(1, std::memory_order_release);
+    std::this_thread::sleep_for(config.warmup);
+    const Clock::time_point tic = Clock::now();
+    phase.store(2, std::memory_order_release);
+    std::this_thread::sleep_for(config.duration);
+    phase.store(3, std::memory_order_release);
+    const Clock::time_point tac = Clock::now();
+    for (std::thread &t : threads)
+        t.join();
+
+    Result result;
+    uint64_t ops = 0;
+    for (const Worker &worker : workers)
+    {
+        ops += worker.ops;
+        result.latencies.merge(worker.latencies);
+    }
+    const double seconds = std::chrono::duration<double>(tac - tic).count();
+    result.mops = static_cast<double>(ops) / seconds / 1e6;
+    return result;
+}
+
+// ----------------------------------------------------------------------------------------------
+// Engines
+// ----------------------------------------------------------------------------------------------
+
+/// @brief Raw mutex, readers and writers are exclusive.
+template<class M, class P>
+class RawEngine
+{
+public:
+    using payload_t = P;
+
+    template<class F>
+    void read(F f)
+    {
+        std::lock_guard<M> lock(m_mutex);
+        f(static_cast<const P &>(m_data));
+    }
+
+    template<class F>
+    void write(F f)
+    {
+        std::lock_guard<M> lock(m_mutex);
+        f(m_data);
+    }
+
+private:
+    M m_mutex;
+    P m_data{};
+};
+
+/// @brief Raw shared mutex, multiple simultaneous readers.
+template<class M, class P>
+class RawSharedEngine
+{
+public:
+    using payload_t = P;
+
+    template<class F>
+    void read(F f)
+    {
+        m_mutex.lock_shared();
+        f(static_cast<const P &>(m_data));
+        m_mutex.unlock_shared();
+    }
+
+    template<class F>
+    void write(F f)
+    {
+        std::lock_guard<M> lock(m_mutex);
+        f(m_data);
+    }
+
+private:
+    M m_mutex;
+    P m_data{};
+};
+
+/// @brief Mustex, reading with `lock()` and writing with `lock_mut()`.
+template<class M, class P>
+class MustexEngine
+{
+public:
+    using payload_t = P;
+
+    template<class F>
+    void read(F f)
+    {
+        auto handle = m_mustex.lock();
+        f(*handle);
+    }
+
+    template<class F>
+    void write(F f)
+    {
+        auto handle = m_mustex.lock_mut();
+        f(*handle);
+    }
+
+private:
+    bcx::Mustex<P, M> m_mustex{P{}};
+};
+
+/// @brief SeqMustex, reading snapshots with `lock()` and writing with `lock_mut()`.
+template<class M, class P>
+class SeqMustexEngine
+{
+public:
+    using payload_t = P;
+
+    template<class F>
+    void read(F f)
+    {
+        auto handle = m_mustex.lock();
+        f(*handle);
+    }
+
+    template<class F>
+    void write(F f)
+    {
+        auto handle = m_mustex.lock_mut();
+        f(*handle);
+    }
+
+private:
+    bcx::SeqMustex<P, M> m_mustex{P{}};
+};
+
+/// @brief RcuMustex, reading current version with `lock()` and copying it with `lock_mut()`.
+template<class M, class P>
+class RcuMustexEngine
+{
+public:
+    using payload_t = P;
+
+    template<class F>
+    void read(F f)
+    {
+        auto handle = m_mustex.lock();
+        f(*handle);
+    }
+
+    template<class F>
+    void write(F f)
+    {
+        auto handle = m_mustex.lock_mut();
+        f(*handle);
+    }
+
+private:
+    bcx::RcuMustex<P, M> m_mustex{P{}};
+};
+
+/// @brief LeftRightMustex, reading with `lock()` and applying the write to both replicas.
+template<class M, class P>
+class LeftRightMustexEngine
+{
+public:
+    using payload_t = P;
+
+    template<class F>
+    void read(F f)
+    {
+        auto handle = m_mustex.lock();
+        f(*handle);
+    }
+
+    template<class F>
+    void write(F f)
+    {
+        m_mustex.modify(f);
+    }
+
+private:
+    bcx::LeftRightMustex<P, M> m_mustex{P{}};
+};
+
+/// @brief CombiningMustex, reading with `lock()` and publishing writes to be combined.
+template<class M, class P>
+class CombiningMustexEngine
+{
+public:
+    using payload_t = P;
+
+    template<class F>
+    void read(F f)
+    {
+        auto handle = m_mustex.lock();
+        f(*handle);
+    }
+
+    template<class F>
+    void write(F f)
+    {
+        m_mustex.apply(f);
+    }
+
+private:
+    bcx::CombiningMustex<P, M> m_mustex{P{}};
+};
+
+/// @brief Two raw mutexes, writers take both using `std::lock`, readers take both in order.
+template<class M, class P>
+class RawPairEngine
+{
+public:
+    using payload_t = P;
+
+    template<class F>
+    void read(F f)
+    {
+        std::lock_guard<M> lock_a(m_mutex_a);
+        std::lock_guard<M> lock_b(m_mutex_b);
+        f(static_cast<const P &>(m_data_a));
+        f(static_cast<const P &>(m_data_b));
+    }
+
+    template<class F>
+    void write(F f)
+    {
+        std::lock(m_mutex_a, m_mutex_b);
+        std::lock_guard<M> lock_a(m_mutex_a, std::adopt_lock);
+        std::lock_guard<M> lock_b(m_mutex_b, std::adopt_lock);
+        f(m_data_a);
+        f(m_data_b);
+    }
+
+private:
+    M m_mutex_a;
+    M m_mutex_b;
+    P m_data_a{};
+    P m_data_b{};
+};
+
+/// @brief Two Mustex, writers take both using `bcx::lock_mut`, readers take both in order.
+template<class M, class P>
+class MustexPairEngine
+{
+public:
+    using payload_t = P;
+
+    template<class F>
+    void read(F f)
+    {
+        auto handle_a = m_mustex_a.lock();
+        auto handle_b = m_mustex_b.lock();
+        f(*handle_a);
+        f(*handle_b);
+    }
+
+    template<class F>
+    void write(F f)
+    {
+        auto handles = bcx::lock_mut(m_mustex_a, m_mustex_b);
+        f(*std::get<0>(handles));
+        f(*std::get<1>(handles));
+    }
+
+private:
+    bcx::Mustex<P, M> m_mustex_a{P{}};
+    bcx::Mustex<P, M> m_mustex_b{P{}};
+};
+
+/// @brief Four Mustex, writers take all of them using `bcx::lock_mut`, passing them in an order
+/// rotating with each write so that concurrent writers start with different ones. Readers take one.
+/// @tparam ORDERED Whether writers use `bcx::ordered_lock`, rather than `std::lock` deadlock avoidance.
+template<class M, class P, bool ORDERED>
+class MustexQuadEngine
+{
+public:
+    using payload_t = P;
+
+    template<class F>
+    void read(F f)
+    {
+        auto handle = m_mustexes[next_rotation() % 4].lock();
+        f(*handle);
+    }
+
+    template<class F>
+    void write(F f)
+    {
+        const unsigned rotation = next_rotation();
+        bcx::Mustex<P, M> &a = m_mustexes[rotation % 4];
+        bcx::Mustex<P, M> &b = m_mustexes[(rotation + 1) % 4];
+        bcx::Mustex<P, M> &c = m_mustexes[(rotation + 2) % 4];
+        bcx::Mustex<P, M> &d = m_mustexes[(rotation + 3) % 4];
+        if (ORDERED)
+            apply(bcx::lock_mut(bcx::ordered_lock, a, b, c, d), f);
+        else
+            apply(bcx::lock_mut(a, b, c, d), f);
+    }
+
+private:
+    static unsigned next_rotation()
+    {
+        static thread_local unsigned rotation = static_cast<unsigned>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        return rotation++;
+    }
+
+    template<class Handles, class F>
+    static void apply(Handles &&handles, F &f)
+    {
+        f(*std::get<0>(handles));
+        f(*std::get<1>(handles));
+        f(*std::get<2>(handles));
+        f(*std::get<3>(handles));
+    }
+
+    bcx::Mustex<P, M> m_mustexes[4];
+};
+
+template<class M, class P>
+using StdLockMustexQuadEngine = MustexQuadEngine<M, P, false>;
+template<class M, class P>
+using OrderedMustexQuadEngine = MustexQuadEngine<M, P, true>;
+
+/// @brief Four Mustex of ranks 0 to 3, writers take all of them using `bcx::lock_mut`, passing them
+/// in an order rotating with each write as MustexQuadEngine does, ranks fixing the locking order at
+/// compile time. Readers take one.
+template<class M, class P>
+class RankedMustexQuadEngine
+{
+public:
+    using payload_t = P;
+
+    template<class F>
+    void read(F f)
+    {
+        switch (next_rotation() % 4)
+        {
+        case 0:
+            f(*m_mustex_0.lock());
+            break;
+        case 1:
+            f(*m_mustex_1.lock());
+            break;
+        case 2:
+            f(*m_mustex_2.lock());
+            break;
+        default:
+            f(*m_mustex_3.lock());
+            break;
+        }
+    }
+
+    template<class F>
+    void write(F f)
+    {
+        switch (next_rotation() % 4)
+        {
+        case 0:
+            apply(bcx::lock_mut(m_mustex_0, m_mustex_1, m_mustex_2, m_mustex_3), f);
+            break;
+        case 1:
+            apply(bcx::lock_mut(m_mustex_1, m_mustex_2, m_mustex_3, m_mustex_0), f);
+            break;
+        case 2:
+            apply(bcx::lock_mut(m_mustex_2, m_mustex_3, m_mustex_0, m_mustex_1), f);
+            break;
+        default:
+            apply(bcx::lock_mut(m_mustex_3, m_mustex_0, m_mustex_1, m_mustex_2), f);
+            break;
+        }
+    }
+
+private:
+    static unsigned next_rotation()
+    {
+        static thread_local unsigned rotation = static_cast<unsigned>(std::hash<std::thread::id>()(std::this_thread::get_id()));
+        return rotation++;
+    }
+
+    template<class Handles, class F>
+    static void apply(Handles &&handles, F &f)
+    {
+        f(*std::get<0>(handles));
+        f(*std::get<1>(handles));
+        f(*std::get<2>(handles));
+        f(*std::get<3>(handles));
+    }
+
+    bcx::Mustex<P, bcx::Ranked<M, 0>> m_mustex_0;
+    bcx::Mustex<P, bcx::Ranked<M, 1>> m_mustex_1;
+    bcx::Mustex<P, bcx::Ranked<M, 2>> m_mustex_2;
+    bcx::Mustex<P, bcx::Ranked<M, 3>> m_mustex_3;
+};
+
+// ----------------------------------------------------------------------------------------------
+// Registry and command line
+// ----------------------------------------------------------------------------------------------
+
+using Runner = std::function<Result(const Config &)>;
+
+struct EngineEntry
+{
+    std::string name;
+    Runner runner;
+};
+
+/// @brief Dispatch runtime payload size to the engine instantiated for it.
+template<template<class, class> class E, class M>
+Result run_sized(const Config &config)
+{
+    switch (config.payload_bytes)
+    {
+    case 8:
+        return run<E<M, Payload<1>>>(config);
+    case 64:
+        return run<E<M, Payload<8>>>(config);
+    case 512:
+        return run<E<M, Payload<64>>>(config);
+    default:
+        return run<E<M, Payload<512>>>(config);
+    }
+}
+
+template<template<class, class> class E, class M>
+void add_engine(std::vector<EngineEntry> &engines, const char *name)
+{
+    EngineEntry entry;
+    entry.name = name;
+    entry.runner = &run_sized<E, M>;
+    engines.push_back(entry);
+}
+
+std::vector<EngineEntry> make_engines()
+{
+    std::vector<EngineEntry> engines;
+    add_engine<RawEngine, std::mutex>(engines, "std::mutex");
+    add_engine<MustexEngine, std::mutex>(engines, "Mustex<T, std::mutex>");
+#ifdef _MUSTEX_HAS_SHARED_MUTEX
+    add_engine<RawSharedEngine, std::shared_timed_mutex>(engines, "std::shared_timed_mutex");
+#endif // #ifdef _MUSTEX_HAS_SHARED_MUTEX
+    add_engine<MustexEngine, bcx::detail::DefaultMustexMutex>(engines, "Mustex<T>");
+#ifdef _MUSTEX_HAS_SHARED_MUTEX
+    add_engine<MustexEngine, std::shared_timed_mutex>(engines, "Mustex<T, std::shared_timed_mutex>");
+#endif // #ifdef _MUSTEX_HAS_SHARED_MUTEX
+    add_engine<MustexEngine, bcx::BasicSharedFutexMutex<bcx::SharedLockPolicy::PreferReaders>>(
+        engines,
+        "Mustex<T, SharedFutexMutex prefer readers>"
+    );
+    add_engine<MustexEngine, bcx::BasicSharedFutexMutex<bcx::SharedLockPolicy::PreferWriters>>(
+        engines,
+        "Mustex<T, SharedFutexMutex prefer writers>"
+    );
+    add_engine<MustexEngine, bcx::BasicSharedFutexMutex<bcx::SharedLockPolicy::PhaseFair>>(
+        engines,
+        "Mustex<T, SharedFutexMutex phase fair>"
+    );
+    add_engine<MustexEngine, bcx::AdaptiveMutex>(engines, "Mustex<T, AdaptiveMutex>");
+    add_engine<MustexEngine, bcx::DistributedSharedMutex>(engines, "Mustex<T, DistributedSharedMutex>");
+    add_engine<MustexEngine, bcx::ParkingLotMutex>(engines, "Mustex<T, ParkingLotMutex>");
+    add_engine<MustexEngine, bcx::McsMutex>(engines, "Mustex<T, McsMutex>");
+    add_engine<MustexEngine, bcx::McsSharedMutex>(engines, "Mustex<T, McsSharedMutex>");
+    add_engine<MustexEngine, bcx::CohortMutex>(engines, "Mustex<T, CohortMutex>");
+    add_engine<MustexEngine, bcx::WithWaitStrategy<bcx::detail::DefaultMustexMutex, bcx::SpinWait>>(
+        engines,
+        "Mustex<T, WithWaitStrategy<SpinWait>>"
+    );
+#ifdef _MUSTEX_HAS_PI_MUTEX
+    add_engine<MustexEngine, bcx::PiMutex>(engines, "Mustex<T, PiMutex>");
+#endif // #ifdef _MUSTEX_HAS_PI_MUTEX
+    add_engine<SeqMustexEngine, std::mutex>(engines, "SeqMustex<T, std::mutex>");
+    add_engine<RcuMustexEngine, std::mutex>(engines, "RcuMustex<T, std::mutex>");
+    add_engine<LeftRightMustexEngine, std::mutex>(engines, "LeftRightMustex<T, std::mutex>");
+    add_engine<CombiningMustexEngine, bcx::detail::DefaultMustexMutex>(engines, "CombiningMustex<T>");
+    add_engine<RawPairEngine, std::mutex>(engines, "std::lock(2 x std::mutex)");
+    add_engine<MustexPairEngine, bcx::detail::DefaultMustexMutex>(engines, "bcx::lock_mut(2 x Mustex<T>)");
+    add_engine<StdLockMustexQuadEngine, bcx::detail::DefaultMustexMutex>(engines, "bcx::lock_mut(4 x Mustex<T>)");
+    add_engine<OrderedMustexQuadEngine, bcx::detail::DefaultMustexMutex>(engines, "bcx::lock_mut(ordered, 4 x Mustex<T>)");
+    add_engine<RankedMustexQuadEngine, bcx::detail::DefaultMustexMutex>(engines, "bcx::lock_mut(4 x ranked Mustex<T>)");
+    return engines;
+}
+
+std::vector<unsigned> parse_list(const char *text)
+{
+    std::vector<unsigned> values;
+    while (*text)
+    {
+        char *end = nullptr;
+        values.push_back(static_cast<unsigned>(std::strtoul(text, &end, 10)));
+        text = *end == ',' ? end + 1 : end;
+        if (end == text && *text)
+            break;
+    }
+    return values;
+}
+
+std::vector<std::string> parse_names(const char *text)
+{
+    std::vector<std::string> names;
+    std::string current;
+    for (; *text; ++text)
+    {
+        if (*text == ',')
+        {
+            names.push_back(current);
+            current.clear();
+        }
+        else
+        {
+            current += *text;
+        }
+    }
+    if (!current.empty())
+        names.push_back(current);
+    return names;
+}
+
+std::vector<unsigned> default_threads()
+{
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> threads;
+    for (unsigned n = 1; n < cores; n *= 2)
+        threads.push_back(n);
+    threads.push_back(cores);
+    return threads;
+}
+
+void print_usage(const char *program)
+{
+    std::printf(
+        "Usage: %s [options]\n"
+        "  --threads=1,2,4     Thread counts to sweep (default: powers of two up to core count).\n"
+        "  --writes=0,5,50     Percentages of write accesses to sweep.\n"
+        "  --cs=0,200          Critical section lengths to sweep, in work units.\n"
+        "  --think=0           Work units spent outside of the lock between two accesses.\n"
+        "  --payload=8,512     Protected data sizes in bytes to sweep (8, 64, 512 or 4096).\n"
+        "  --engines=a,b       Only run engines whose name contains one of given strings.\n"
+        "  --duration=200      Measurement duration of each configuration, in milliseconds.\n"
+        "  --warmup=50         Warmup duration of each configuration, in milliseconds.\n"
+        "  --interval=0        Open-loop pacing of each thread in nanoseconds, 0 for closed loop.\n"
+        "  --smoke             Tiny sweep, only making sure every engine runs.\n"
+        "  --list              List available engines.\n"
+        "\n"
+        "Latencies are acquire latencies in nanoseconds, corrected for coordinated omission.\n",
+        program
+    );
+}
+
+bool matches(const std::string &name, const std::vector<std::string> &filters)
+{
+    if (filters.empty())
+        return true;
+    for (const std::string &filter : filters)
+        if (name.find(filter) != std::string::npos)
+            return true;
+    return false;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    std::vector<unsigned> threads = default_threads();
+    std::vector<unsigned> writes = {0, 5, 50};
+    std::vector<unsigned> cs = {0, 200};
+    std::vector<unsigned> payloads = {8, 512};
+    std::vector<std::string> filters;
+    Config config;
+    config.think_units = 0;
+    config.warmup = std::chrono::milliseconds(50);
+    config.duration = std::chrono::milliseconds(200);
+    config.interval = std::chrono::nanoseconds(0);
+
+    const std::vector<EngineEntry> engines = make_engines();
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *arg = argv[i];
+        const char *value = std::strchr(arg, '=');
+        value = value ? value + 1 : "";
+        if (std::strncmp(arg, "--threads=", 10) == 0)
+            threads = parse_list(value);
+        else if (std::strncmp(arg, "--writes=", 9) == 0)
+            writes = parse_list(value);
+        else if (std::strncmp(arg, "--cs=", 5) == 0)
+            cs = parse_list(value);
+        else if (std::strncmp(arg, "--think=", 8) == 0)
+            config.think_units = static_cast<unsigned>(std::strtoul(value, nullptr, 10));
+        else if (std::strncmp(arg, "--payload=", 10) == 0)
+            payloads = parse_list(value);
+        else if (std::strncmp(arg, "--engines=", 10) == 0)
+            filters = parse_names(value);
+        else if (std::strncmp(arg, "--duration=", 11) == 0)
+            config.duration = std::chrono::milliseconds(std::strtoul(value, nullptr, 10));
+        else if (std::strncmp(arg, "--warmup=", 9) == 0)
+            config.warmup = std::chrono::milliseconds(std::strtoul(value, nullptr, 10));
+        else if (std::strncmp(arg, "--interval=", 11) == 0)
+            config.interval = std::chrono::nanoseconds(std::strtoull(value, nullptr, 10));
+        else if (std::strcmp(arg, "--smoke") == 0)
+        {
+            threads = {1, 2};
+            writes = {0, 50};
+            cs = {0};
+            payloads = {8};
+            config.warmup = std::chrono::milliseconds(2);
+            config.duration = std::chrono::milliseconds(5);
+        }
+        else if (std::strcmp(arg, "--list") == 0)
+        {
+            for (const EngineEntry &engine : engines)
+                std::printf("%s\n", engine.name.c_str());
+            return EXIT_SUCCESS;
+        }
+        else
+        {
+            print_usage(argv[0]);
+            return std::strcmp(arg, "--help") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+
+    std::printf("%-36s %7s %6s %5s %7s %10s %9s %9s %9s\n", "engine", "threads", "write%", "cs", "payload", "Mops/s", "p50", "p99", "p99.9");
+    for (const EngineEntry &engine : engines)
+    {
+        if (!matches(engine.name, filters))
+            continue;
+        for (unsigned payload : payloads)
+            for (unsigned cs_units : cs)
+                for (unsigned write_percent : writes)
+                    for (unsigned thread_count : threads)
+                    {
+                        config.threads = std::max(1u, thread_count);
+                        config.write_percent = write_percent;
+                        config.cs_units = cs_units;
+                        config.payload_bytes = payload;
+                        const Result result = engine.runner(config);
+                        std::printf(
+                            "%-36s %7u %6u %5u %7u %10.3f %9llu %9llu %9llu\n",
+                            engine.name.c_str(),
+                            config.threads,
+                            write_percent,
+                            cs_units,
+                            payload,
+                            result.mops,
+                            static_cast<unsigned long long>(result.latencies.percentile(0.5)),
+                            static_cast<unsigned long long>(result.latencies.percentile(0.99)),
+                            static_cast<unsigned long long>(result.latencies.percentile(0.999))
+                        );
+                        std::fflush(stdout);
+                    }
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,170 @@
+#ifndef BCX_ADAPTIVE_MUTEX_HPP
+#define BCX_ADAPTIVE_MUTEX_HPP
+
+#include "mustex.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace bcx
+{
+
+/// @brief Reader-writer mutex spinning for a while before parking, for short critical sections.
+/// A thread failing to acquire the mutex first spins with exponential backoff, as it is likely to be
+/// released within a few hundred nanoseconds, and only then parks on a futex. The spinning budget
+/// tunes itself to how long the mutex has recently been held: it follows a moving average of the
+/// spins it took previous waiters to acquire it, so that waiters on a mutex held too long to be
+/// worth spinning on park almost right away.
+/// Neither readers nor writers are given preference.
+/// Meets the SharedTimedLockable requirements, and can be used as `Mustex<T, AdaptiveMutex>`.
+class AdaptiveMutex
+{
+public:
+    AdaptiveMutex() = default;
+    AdaptiveMutex(const AdaptiveMutex &) = delete;
+    AdaptiveMutex &operator=(const AdaptiveMutex &) = delete;
+
+    void lock()
+    {
+        if (!try_acquire(WRITER | READERS, WRITER))
+            lock_slow<std::chrono::steady_clock, std::chrono::steady_clock::duration>(WRITER | READERS, WRITER, nullptr);
+    }
+
+    bool try_lock()
+    {
+        return try_acquire(WRITER | READERS, WRITER);
+    }
+
+    template<typename Rep, typename Period>
+    bool try_lock_for(const std::chrono::duration<Rep, Period> &d)
+    {
+        return try_lock_until(std::chrono::steady_clock::now() + d);
+    }
+
+    template<typename Clock, typename Duration>
+    bool try_lock_until(const std::chrono::time_point<Clock, Duration> &tp)
+    {
+        return try_acquire(WRITER | READERS, WRITER) || lock_slow(WRITER | READERS, WRITER, &tp);
+    }
+
+    void unlock()
+    {
+        if (m_state.exchange(0, std::memory_order_release) & PARKED)
+            detail::futex_wake_all(m_state);
+    }
+
+    void lock_shared()
+    {
+        if (!try_acquire(WRITER, 1))
+            lock_slow<std::chrono::steady_clock, std::chrono::steady_clock::duration>(WRITER, 1, nullptr);
+    }
+
+    bool try_lock_shared()
+    {
+        return try_acquire(WRITER, 1);
+    }
+
+    template<typename Rep, typename Period>
+    bool try_lock_shared_for(const std::chrono::duration<Rep, Period> &d)
+    {
+        return try_lock_shared_until(std::chrono::steady_clock::now() + d);
+    }
+
+    template<typename Clock, typename Duration>
+    bool try_lock_shared_until(const std::chrono::time_point<Clock, Duration> &tp)
+    {
+        return try_acquire(WRITER, 1) || lock_slow(WRITER, 1, &tp);
+    }
+
+    void unlock_shared()
+    {
+        if (m_state.fetch_sub(1, std::memory_order_release) != (PARKED | 1))
+            return;
+        // Last reader out while threads are parked. A reader or writer may have come in meanwhile,
+        // in which case it is now responsible for waking them up.
+        std::uint32_t expected = PARKED;
+        if (m_state.compare_exchange_strong(expected, 0, std::memory_order_relaxed))
+            detail::futex_wake_all(m_state);
+    }
+
+private:
+    static constexpr std::uint32_t WRITER = 1u << 31;
+    static constexpr std::uint32_t PARKED = 1u << 30;
+    static constexpr std::uint32_t READERS = PARKED - 1;
+
+    static constexpr std::int32_t MIN_SPINS = 16;
+    static constexpr std::int32_t MAX_SPINS = 1024;
+    static constexpr std::int32_t MAX_SPIN_STEP = 64;
+
+    /// @brief Make a single attempt at acquiring the mutex, retrying only on concurrent modifications.
+    /// @param blocking State bits preventing acquisition.
+    /// @param increment Value added to the state on acquisition.
+    bool try_acquire(std::uint32_t blocking, std::uint32_t increment)
+    {
+        std::uint32_t state = m_state.load(std::memory_order_relaxed);
+        while (!(state & blocking))
+            if (m_state.compare_exchange_weak(state, state + increment, std::memory_order_acquire, std::memory_order_relaxed))
+                return true;
+        return false;
+    }
+
+    /// @brief Spin with exponential backoff for the current budget, and update the budget.
+    /// @return True if the mutex was acquired.
+    bool spin(std::uint32_t blocking, std::uint32_t increment)
+    {
+        const std::int32_t average = m_spins.load(std::memory_order_relaxed);
+        std::int32_t limit = average * 2 + MIN_SPINS;
+        if (limit > MAX_SPINS)
+            limit = MAX_SPINS;
+        std::int32_t spins = 0;
+        std::int32_t step = 1;
+        bool acquired = false;
+        while (spins < limit && !(acquired = try_acquire(blocking, increment)))
+        {
+            for (std::int32_t i = 0; i < step; ++i)
+                detail::cpu_relax();
+            spins += step;
+            if (step < MAX_SPIN_STEP)
+                step *= 2;
+        }
+        // Budget is kept about twice the spins successful waiters needed, and shrinks each time a
+        // waiter gives up, as the mutex is then held longer than spinning is worth.
+        m_spins.store(acquired ? average + (spins - average) / 8 : average - average / 8, std::memory_order_relaxed);
+        return acquired;
+    }
+
+    /// @brief Spin then park until the mutex is acquired or the deadline, if any, is reached.
+    template<typename Clock, typename Duration>
+    bool lock_slow(std::uint32_t blocking, std::uint32_t increment, const std::chrono::time_point<Clock, Duration> *tp)
+    {
+        if (spin(blocking, increment))
+            return true;
+        std::uint32_t state = m_state.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            if (!(state & blocking))
+            {
+                if (m_state.compare_exchange_weak(state, state + increment, std::memory_order_acquire, std::memory_order_relaxed))
+                    return true;
+                continue;
+            }
+            if (!(state & PARKED) && !m_state.compare_exchange_weak(state, state | PARKED, std::memory_order_relaxed))
+                continue;
+            if (!tp)
+                detail::futex_wait(m_state, state | PARKED);
+            else if (!detail::futex_wait_until(m_state, state | PARKED, *tp))
+                return false;
+            state = m_state.load(std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief Writer bit, parked bit and number of readers.
+    std::atomic<std::uint32_t> m_state{0};
+    /// @brief Moving average of spins needed to acquire the mutex.
+    std::atomic<std::int32_t> m_spins{0};
+};
+
+} // namespace bcx
+
+#endif // #ifndef BCX_ADAPTIVE_MUTEX_HPP
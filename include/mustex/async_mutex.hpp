@@ -0,0 +1,308 @@
+#ifndef BCX_ASYNC_MUTEX_HPP
+#define BCX_ASYNC_MUTEX_HPP
+
+#include "mustex.hpp"
+
+#if defined(__cpp_impl_coroutine) && defined(__has_include)
+#    if __has_include(<coroutine>)
+#        define _MUSTEX_HAS_COROUTINES
+#        include <coroutine>
+#    endif
+#endif // #if defined(__cpp_impl_coroutine) && defined(__has_include)
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <utility>
+
+namespace bcx
+{
+
+class AsyncMutex;
+
+namespace detail
+{
+/// @brief Coroutine, thread or other waiter queued up on an AsyncMutex, woken up once the mutex is
+/// handed over to it.
+struct AsyncWaiter
+{
+    AsyncWaiter *next = nullptr;
+    bool exclusive = false;
+    void (*wake)(AsyncWaiter &) = nullptr;
+};
+} // namespace detail
+
+#ifdef _MUSTEX_HAS_COROUTINES
+/// @brief Executor resuming coroutines right away, in the thread handing the mutex over to them.
+struct InlineExecutor
+{
+    void operator()(std::coroutine_handle<> coroutine) const
+    {
+        coroutine.resume();
+    }
+};
+
+namespace detail
+{
+/// @brief Awaitable acquiring an AsyncMutex, see AsyncMutex::lock_async().
+/// @tparam Executor Callable resuming the coroutine once handed the mutex, given its handle.
+template<typename Executor>
+class AsyncLockAwaiter : private AsyncWaiter
+{
+public:
+    AsyncLockAwaiter(AsyncMutex &mutex, bool exclusive, Executor executor)
+        : m_mutex(mutex)
+        , m_executor(std::move(executor))
+    {
+        this->exclusive = exclusive;
+        this->wake = &AsyncLockAwaiter::resume;
+    }
+
+    /// @brief Always suspends, the mutex being only checked once the coroutine may be queued up.
+    bool await_ready() const { return false; }
+
+    /// @return False to resume the coroutine right away if the mutex was acquired.
+    bool await_suspend(std::coroutine_handle<> coroutine);
+
+    void await_resume() const {}
+
+private:
+    static void resume(AsyncWaiter &waiter)
+    {
+        AsyncLockAwaiter &self = static_cast<AsyncLockAwaiter &>(waiter);
+        self.m_executor(self.m_coroutine);
+    }
+
+    AsyncMutex &m_mutex;
+    Executor m_executor;
+    std::coroutine_handle<> m_coroutine;
+};
+} // namespace detail
+#endif // #ifdef _MUSTEX_HAS_COROUTINES
+
+/// @brief Reader-writer mutex which coroutines and event loops wait for without blocking their thread.
+/// `co_await mutex.lock_async()` suspends the calling coroutine and queues it up while the mutex is
+/// unavailable. On unlock, the mutex is handed over to queued waiters in arrival order, a writer or
+/// consecutive readers at once, and their coroutines resumed by the executor given when locking,
+/// by default InlineExecutor resuming them in the unlocking thread. Threads locking the mutex
+/// synchronously queue up alike and block until handed the mutex. Newcomers never overtake queued
+/// waiters, hence writers cannot be starved.
+/// The state of the mutex is guarded by an internal std::mutex, only held for a few instructions.
+/// Awaitables are only available with C++20 coroutines, where `_MUSTEX_HAS_COROUTINES` is defined.
+/// Meets the SharedLockable requirements, and can be used as `Mustex<T, AsyncMutex>`, enabling
+/// Mustex::lock_async() and Mustex::lock_mut_async(), and EventfdLock.
+class AsyncMutex
+{
+public:
+    AsyncMutex() = default;
+    AsyncMutex(const AsyncMutex &) = delete;
+    AsyncMutex &operator=(const AsyncMutex &) = delete;
+
+    void lock()
+    {
+        acquire_sync(true);
+    }
+
+    bool try_lock()
+    {
+        std::lock_guard<std::mutex> guard(m_guard);
+        return try_acquire(true);
+    }
+
+    void unlock()
+    {
+        release(true);
+    }
+
+    void lock_shared()
+    {
+        acquire_sync(false);
+    }
+
+    bool try_lock_shared()
+    {
+        std::lock_guard<std::mutex> guard(m_guard);
+        return try_acquire(false);
+    }
+
+    void unlock_shared()
+    {
+        release(false);
+    }
+
+#ifdef _MUSTEX_HAS_COROUTINES
+    /// @brief Lock the mutex exclusively from a coroutine: `co_await mutex.lock_async();`.
+    /// @param executor Callable resuming the coroutine given its handle, if it had to wait.
+    template<typename Executor = InlineExecutor>
+    detail::AsyncLockAwaiter<Executor> lock_async(Executor executor = {})
+    {
+        return detail::AsyncLockAwaiter<Executor>(*this, true, std::move(executor));
+    }
+
+    /// @brief Lock the mutex for reading from a coroutine: `co_await mutex.lock_shared_async();`.
+    /// @param executor Callable resuming the coroutine given its handle, if it had to wait.
+    template<typename Executor = InlineExecutor>
+    detail::AsyncLockAwaiter<Executor> lock_shared_async(Executor executor = {})
+    {
+        return detail::AsyncLockAwaiter<Executor>(*this, false, std::move(executor));
+    }
+#endif // #ifdef _MUSTEX_HAS_COROUTINES
+
+    /// @brief Acquire the mutex, or queue given waiter up if unavailable, for waiters other than
+    /// coroutines and threads, such as EventfdLock.
+    /// @return True if acquired, otherwise the waiter is woken up once handed the mutex.
+    bool acquire_or_enqueue(detail::AsyncWaiter &waiter)
+    {
+        std::lock_guard<std::mutex> guard(m_guard);
+        if (try_acquire(waiter.exclusive))
+            return true;
+        waiter.next = nullptr;
+        (m_tail ? m_tail->next : m_head) = &waiter;
+        m_tail = &waiter;
+        return false;
+    }
+
+    /// @brief Remove given waiter from the queue, if still queued up.
+    /// @return False if the mutex was already handed over to the waiter, which is then woken up,
+    ///         or about to be.
+    bool cancel(detail::AsyncWaiter &waiter)
+    {
+        detail::AsyncWaiter *woken = nullptr;
+        {
+            std::lock_guard<std::mutex> guard(m_guard);
+            detail::AsyncWaiter *previous = nullptr;
+            detail::AsyncWaiter *current = m_head;
+            while (current && current != &waiter)
+            {
+                previous = current;
+                current = current->next;
+            }
+            if (!current)
+                return false;
+            (previous ? previous->next : m_head) = current->next;
+            if (m_tail == current)
+                m_tail = previous;
+            // Readers queued up behind a cancelled writer join the readers holding the mutex.
+            if (!previous && m_head && m_state != WRITER && !m_head->exclusive)
+                woken = hand_over();
+        }
+        wake(woken);
+        return true;
+    }
+
+private:
+    /// @brief Thread waiting synchronously, parked until handed the mutex.
+    struct ThreadWaiter : detail::AsyncWaiter
+    {
+        std::atomic<std::uint32_t> granted{0};
+    };
+
+    static constexpr std::int32_t WRITER = -1;
+
+    /// @brief Acquire the mutex if available and no one is queued up, guard must be held.
+    bool try_acquire(bool exclusive)
+    {
+        if (m_head)
+            return false;
+        if (exclusive)
+        {
+            if (m_state != 0)
+                return false;
+            m_state = WRITER;
+            return true;
+        }
+        if (m_state == WRITER)
+            return false;
+        ++m_state;
+        return true;
+    }
+
+    void acquire_sync(bool exclusive)
+    {
+        ThreadWaiter waiter;
+        waiter.exclusive = exclusive;
+        waiter.wake = [](detail::AsyncWaiter &w)
+        {
+            ThreadWaiter &self = static_cast<ThreadWaiter &>(w);
+            self.granted.store(1, std::memory_order_release);
+            // The woken thread may already be gone, waking an address no one waits on is harmless.
+            detail::futex_wake_one(self.granted);
+        };
+        if (acquire_or_enqueue(waiter))
+            return;
+        while (!waiter.granted.load(std::memory_order_acquire))
+            detail::futex_wait(waiter.granted, 0);
+    }
+
+    void release(bool exclusive)
+    {
+        detail::AsyncWaiter *woken = nullptr;
+        {
+            std::lock_guard<std::mutex> guard(m_guard);
+            m_state = exclusive ? 0 : m_state - 1;
+            if (m_state == 0 && m_head)
+                woken = hand_over();
+        }
+        wake(woken);
+    }
+
+    /// @brief Dequeue the waiters the mutex is handed over to, either the first writer if the mutex
+    /// is free, or consecutive readers joining current ones, guard must be held.
+    /// @return List of dequeued waiters, linked by their `next` member.
+    detail::AsyncWaiter *hand_over()
+    {
+        detail::AsyncWaiter *first = m_head;
+        detail::AsyncWaiter *last = first;
+        if (first->exclusive)
+        {
+            m_state = WRITER;
+        }
+        else
+        {
+            ++m_state;
+            for (; last->next && !last->next->exclusive; last = last->next)
+                ++m_state;
+        }
+        m_head = last->next;
+        if (!m_head)
+            m_tail = nullptr;
+        last->next = nullptr;
+        return first;
+    }
+
+    /// @brief Wake dequeued waiters up, once the guard is released as inline executors resume
+    /// coroutines right away, which may lock the mutex again.
+    static void wake(detail::AsyncWaiter *woken)
+    {
+        while (woken)
+        {
+            detail::AsyncWaiter *next = woken->next;
+            woken->wake(*woken);
+            woken = next;
+        }
+    }
+
+    std::mutex m_guard;
+    /// @brief WRITER if locked exclusively, otherwise number of readers.
+    std::int32_t m_state = 0;
+    /// @brief Queue of waiters, in arrival order.
+    detail::AsyncWaiter *m_head = nullptr;
+    detail::AsyncWaiter *m_tail = nullptr;
+};
+
+#ifdef _MUSTEX_HAS_COROUTINES
+namespace detail
+{
+template<typename Executor>
+bool AsyncLockAwaiter<Executor>::await_suspend(std::coroutine_handle<> coroutine)
+{
+    // Once queued up, the coroutine may be resumed by another thread before this returns.
+    m_coroutine = coroutine;
+    return !m_mutex.acquire_or_enqueue(*this);
+}
+} // namespace detail
+#endif // #ifdef _MUSTEX_HAS_COROUTINES
+
+} // namespace bcx
+
+#endif // #ifndef BCX_ASYNC_MUTEX_HPP
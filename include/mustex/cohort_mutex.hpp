@@ -0,0 +1,250 @@
+#ifndef BCX_COHORT_MUTEX_HPP
+#define BCX_COHORT_MUTEX_HPP
+
+#include "mustex.hpp"
+
+#if defined(__linux__)
+#    include <sched.h>
+#    include <fstream>
+#    include <sstream>
+#    include <string>
+#endif // #if defined(__linux__)
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace bcx
+{
+
+namespace detail
+{
+/// @brief NUMA nodes of the machine, read once from /sys on Linux. Machines where it cannot be
+/// read are considered to be a single node.
+class NumaTopology
+{
+public:
+    static const NumaTopology &instance()
+    {
+        static const NumaTopology topology;
+        return topology;
+    }
+
+    std::size_t nodes() const { return m_nodes; }
+
+    /// @brief Node calling thread is currently running on, unless simulated.
+    std::size_t this_thread_node() const
+    {
+        const std::size_t simulated = simulated_node();
+        if (simulated != NOT_SIMULATED)
+            return simulated;
+#if defined(__linux__)
+        const int cpu = sched_getcpu();
+        if (cpu >= 0 && static_cast<std::size_t>(cpu) < m_cpu_nodes.size())
+            return m_cpu_nodes[static_cast<std::size_t>(cpu)];
+#endif // #if defined(__linux__)
+        return 0;
+    }
+
+    /// @brief Make calling thread be considered as running on given node, for testing purposes.
+    static void simulate_this_thread_node(std::size_t node)
+    {
+        simulated_node() = node;
+    }
+
+private:
+    static constexpr std::size_t NOT_SIMULATED = static_cast<std::size_t>(-1);
+
+    std::size_t m_nodes = 1;
+    std::vector<std::size_t> m_cpu_nodes;
+
+    NumaTopology()
+    {
+#if defined(__linux__)
+        const std::vector<std::size_t> possible = read_list("/sys/devices/system/node/possible");
+        for (std::size_t node : possible)
+        {
+            if (node + 1 > m_nodes)
+                m_nodes = node + 1;
+            const std::vector<std::size_t> cpus = read_list("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist");
+            for (std::size_t cpu : cpus)
+            {
+                if (cpu >= m_cpu_nodes.size())
+                    m_cpu_nodes.resize(cpu + 1, 0);
+                m_cpu_nodes[cpu] = node;
+            }
+        }
+#endif // #if defined(__linux__)
+    }
+
+    static std::size_t &simulated_node()
+    {
+        static thread_local std::size_t node = NOT_SIMULATED;
+        return node;
+    }
+
+#if defined(__linux__)
+    /// @brief Parse a kernel list file such as "0-3,8-11", empty if it cannot be read.
+    static std::vector<std::size_t> read_list(const std::string &path)
+    {
+        std::vector<std::size_t> values;
+        std::ifstream file(path);
+        std::string range;
+        while (std::getline(file, range, ','))
+        {
+            std::istringstream stream(range);
+            std::size_t first = 0;
+            std::size_t last = 0;
+            char dash = 0;
+            if (!(stream >> first))
+                break;
+            if (!(stream >> dash >> last) || dash != '-')
+                last = first;
+            for (std::size_t value = first; value <= last; ++value)
+                values.push_back(value);
+        }
+        return values;
+    }
+#endif // #if defined(__linux__)
+};
+} // namespace detail
+
+/// @brief NUMA-aware cohort lock, keeping the mutex within a node while threads of this node wait.
+/// The mutex is made of a global mutex and a local mutex per NUMA node. A thread first acquires the
+/// local mutex of the node it runs on, then the global one. On unlock, if other threads of the same
+/// node wait, the global mutex is passed on to them along with the local one, so that data stays in
+/// the caches of this node. The global mutex is passed on a bounded number of times in a row, after
+/// which it is released to let other nodes in.
+/// Timed acquisitions do not wait on local mutexes, they poll the mutex until free or the deadline
+/// is reached, hence may be overtaken by other threads.
+/// On single node machines, this is a mere mutex with an extra uncontended acquisition.
+/// Meets the TimedLockable requirements, and can be used as `Mustex<T, CohortMutex>`. Readers are
+/// then exclusive too.
+class CohortMutex
+{
+public:
+    /// @brief Default number of times in a row the mutex is passed on within a node.
+    static constexpr unsigned DEFAULT_MAX_HANDOFFS = 64;
+
+    /// @brief Create mutex with a local mutex for each node of the machine.
+    CohortMutex()
+        : CohortMutex(detail::NumaTopology::instance().nodes())
+    {
+    }
+
+    /// @brief Create mutex with given number of local mutexes, threads running on nodes beyond
+    /// sharing them.
+    /// @param nodes Number of local mutexes.
+    /// @param max_handoffs Number of times in a row the mutex may be passed on within a node.
+    explicit CohortMutex(std::size_t nodes, unsigned max_handoffs = DEFAULT_MAX_HANDOFFS)
+        : m_nodes{new Node[nodes ? nodes : 1]}
+        , m_node_count{nodes ? nodes : 1}
+        , m_max_handoffs{max_handoffs}
+    {
+    }
+
+    CohortMutex(const CohortMutex &) = delete;
+    CohortMutex &operator=(const CohortMutex &) = delete;
+
+    void lock()
+    {
+        Node &node = this_thread_node();
+        node.waiters.fetch_add(1, std::memory_order_relaxed);
+        node.local.lock();
+        node.waiters.fetch_sub(1, std::memory_order_relaxed);
+        if (!node.global_owned)
+            m_global.lock();
+        m_owner = &node;
+    }
+
+    bool try_lock()
+    {
+        Node &node = this_thread_node();
+        if (!node.local.try_lock())
+            return false;
+        if (!node.global_owned && !m_global.try_lock())
+        {
+            node.local.unlock();
+            return false;
+        }
+        m_owner = &node;
+        return true;
+    }
+
+    template<typename Rep, typename Period>
+    bool try_lock_for(const std::chrono::duration<Rep, Period> &d)
+    {
+        return try_lock_until(std::chrono::steady_clock::now() + d);
+    }
+
+    template<typename Clock, typename Duration>
+    bool try_lock_until(const std::chrono::time_point<Clock, Duration> &tp)
+    {
+        detail::Backoff backoff;
+        while (!try_lock())
+        {
+            if (Clock::now() >= tp)
+                return false;
+            backoff.pause();
+        }
+        return true;
+    }
+
+    void unlock()
+    {
+        Node &node = *m_owner;
+        // Waiters only leave once they hold the local mutex, one of them is bound to take it over.
+        if (node.waiters.load(std::memory_order_relaxed) != 0 && node.handoffs < m_max_handoffs)
+        {
+            ++node.handoffs;
+            node.global_owned = true;
+        }
+        else
+        {
+            node.handoffs = 0;
+            node.global_owned = false;
+            m_global.unlock();
+        }
+        node.local.unlock();
+    }
+
+    /// @brief Make calling thread be considered as running on given node by every CohortMutex, for
+    /// testing purposes.
+    static void simulate_this_thread_node(std::size_t node)
+    {
+        detail::NumaTopology::simulate_this_thread_node(node);
+    }
+
+private:
+    /// @brief Local mutex of a node, and state of the cohort it protects, alone on its cache line.
+    struct Node
+    {
+        char padding_front[64];
+        SharedFutexMutex local;
+        /// @brief Number of threads waiting for the local mutex.
+        std::atomic<std::uint32_t> waiters{0};
+        /// @brief Whether the global mutex was passed on to the next holder of the local mutex.
+        bool global_owned = false;
+        /// @brief Number of times in a row the global mutex was passed on.
+        unsigned handoffs = 0;
+        char padding_back[64];
+    };
+
+    Node &this_thread_node()
+    {
+        return m_nodes[detail::NumaTopology::instance().this_thread_node() % m_node_count];
+    }
+
+    const std::unique_ptr<Node[]> m_nodes;
+    const std::size_t m_node_count;
+    const unsigned m_max_handoffs;
+    SharedFutexMutex m_global;
+    /// @brief Node of the thread holding the mutex, only accessed by this thread.
+    Node *m_owner = nullptr;
+};
+
+} // namespace bcx
+
+#endif // #ifndef BCX_COHORT_MUTEX_HPP
@@ -0,0 +1,291 @@
+#ifndef BCX_COMBINING_MUSTEX_HPP
+#define BCX_COMBINING_MUSTEX_HPP
+
+#include "mustex.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <type_traits>
+#include <utility>
+
+namespace bcx
+{
+
+namespace detail
+{
+/// @brief Number of publication slots of a CombiningMustex, shared by threads in a round-robin manner.
+constexpr std::size_t COMBINING_SLOTS = 32;
+
+/// @brief Operation published by a thread, applied by whichever thread combines them.
+template<typename T>
+struct CombinedOperation
+{
+    void (*run)(CombinedOperation &, T &) = nullptr;
+    std::exception_ptr error;
+};
+
+/// @brief Publication slot of a CombiningMustex, alone on its cache line.
+template<typename T>
+struct CombiningSlot
+{
+    enum : std::uint32_t
+    {
+        FREE,
+        CLAIMED,
+        PENDING,
+        /// @brief Pending, and its publisher is blocked on `state` until it changes.
+        PARKED,
+        DONE
+    };
+
+    char padding_front[64];
+    std::atomic<std::uint32_t> state{FREE};
+    CombinedOperation<T> *operation = nullptr;
+    char padding_back[64];
+};
+
+/// @brief Operation calling F on owned data, and keeping its result for the publishing thread.
+template<typename T, typename F, typename R = typename std::decay<decltype(std::declval<F &>()(std::declval<T &>()))>::type>
+struct CombinedCall : CombinedOperation<T>
+{
+    explicit CombinedCall(F &f)
+        : function(f)
+    {
+        this->run = [](CombinedOperation<T> &operation, T &data)
+        {
+            CombinedCall &self = static_cast<CombinedCall &>(operation);
+            self.result = self.function(data);
+        };
+    }
+
+    R get() { return std::move(*result); }
+
+    F &function;
+    Optional<R> result;
+};
+
+template<typename T, typename F>
+struct CombinedCall<T, F, void> : CombinedOperation<T>
+{
+    explicit CombinedCall(F &f)
+        : function(f)
+    {
+        this->run = [](CombinedOperation<T> &operation, T &data)
+        {
+            static_cast<CombinedCall &>(operation).function(data);
+        };
+    }
+
+    void get() {}
+
+    F &function;
+};
+} // namespace detail
+
+/// @brief Data-owning flat combining synchronization, for many threads applying small operations.
+/// Instead of locking, threads publish their operation as a callable into a slot, and whichever
+/// thread acquires the mutex applies all pending operations in one pass, sparing a lock handoff per
+/// operation. Publishers spin while their operation is pending, trying to acquire the mutex to
+/// combine pending operations themselves, and park on their slot while another thread combines.
+/// Data can also be locked as in a Mustex, publishers then waiting for the handle to be dropped to
+/// combine pending operations.
+/// @tparam T The type of data to be shared among threads.
+/// @tparam M Type of synchronization mutex.
+template<class T, class M = detail::DefaultMustexMutex>
+class CombiningMustex
+{
+public:
+    /// @brief The type of contained value, exposed for convenience.
+    using data_t = typename std::remove_cv<T>::type;
+    /// @brief The type of mutex used, exposed for convenience.
+    using mutex_t = M;
+    /// @brief The type of handle used to access data.
+    using Handle = typename Mustex<data_t, M>::Handle;
+    /// @brief The type of handle used to access data mutably.
+    using HandleMut = typename Mustex<data_t, M>::HandleMut;
+
+    template<typename... Args>
+    CombiningMustex(Args &&...args)
+        : m_mustex(std::forward<Args>(args)...)
+    {
+    }
+
+    CombiningMustex(const CombiningMustex &) = delete;
+    CombiningMustex(CombiningMustex &&other) = delete;
+    CombiningMustex &operator=(const CombiningMustex &other) = delete;
+    CombiningMustex &operator=(CombiningMustex &&other) = delete;
+
+    ~CombiningMustex() = default;
+
+    /// @brief Apply given operation to owned data, possibly from another thread along with the
+    /// operations of other threads, and wait for its result.
+    /// The operation must not access this CombiningMustex, nor rely on calling thread.
+    /// @param f Callable accepting a `data_t &`.
+    /// @return Result of the operation, by value.
+    /// @throw Exception thrown by the operation, if any.
+    template<typename F>
+    auto apply(F f) -> typename std::decay<decltype(f(std::declval<data_t &>()))>::type
+    {
+        detail::CombinedCall<data_t, F> call(f);
+        Slot *slot = claim();
+        if (!slot)
+        {
+            // All slots are taken, apply the operation directly.
+            {
+                auto handle = m_mustex.lock_mut();
+                call.run(call, *handle);
+                combine_locked(*handle);
+            }
+            wake_parked();
+            return call.get();
+        }
+        slot->operation = &call;
+        slot->state.store(Slot::PENDING, std::memory_order_release);
+
+        detail::Backoff backoff;
+        while (slot->state.load(std::memory_order_acquire) != Slot::DONE)
+        {
+            if (!m_combining.load(std::memory_order_relaxed))
+            {
+                // No other thread combines, try to, yielding once spin budget is exhausted.
+                if (auto handle = m_mustex.try_lock_mut())
+                {
+                    combine_locked(**handle);
+                }
+                else
+                {
+                    backoff.pause();
+                    continue;
+                }
+                wake_parked();
+            }
+            else if (backoff.is_spinning())
+            {
+                backoff.pause();
+            }
+            else
+            {
+                park(*slot);
+            }
+        }
+        slot->state.store(Slot::FREE, std::memory_order_release);
+        if (call.error)
+            std::rethrow_exception(call.error);
+        return call.get();
+    }
+
+    /// @brief Lock data for read-only access.
+    /// @return Handle on owned data.
+    Handle lock() const
+    {
+        return m_mustex.lock();
+    }
+
+    /// @brief Try to lock data for read-only access.
+    /// @return Handle on owned data if available. Check before use.
+    detail::Optional<Handle> try_lock() const
+    {
+        return m_mustex.try_lock();
+    }
+
+    /// @brief Lock data for write access, publishers waiting for the handle to be dropped to combine
+    /// pending operations.
+    /// @return Handle on owned data.
+    HandleMut lock_mut()
+    {
+        return m_mustex.lock_mut();
+    }
+
+    /// @brief Try to lock data for write access.
+    /// @return Handle on owned data if available. Check before use.
+    detail::Optional<HandleMut> try_lock_mut()
+    {
+        return m_mustex.try_lock_mut();
+    }
+
+private:
+    using Slot = detail::CombiningSlot<data_t>;
+
+    /// @brief Claim a free slot, starting from the one assigned to calling thread.
+    /// @return Claimed slot, null if all are taken.
+    Slot *claim()
+    {
+        const std::size_t first = detail::this_thread_index();
+        for (std::size_t i = 0; i < detail::COMBINING_SLOTS; ++i)
+        {
+            Slot &slot = m_slots[(first + i) % detail::COMBINING_SLOTS];
+            std::uint32_t state = Slot::FREE;
+            if (slot.state.load(std::memory_order_relaxed) == Slot::FREE &&
+                slot.state.compare_exchange_strong(state, Slot::CLAIMED, std::memory_order_acquire, std::memory_order_relaxed))
+                return &slot;
+        }
+        return nullptr;
+    }
+
+    /// @brief Apply all pending operations to given data as the combining thread, mutex must be held.
+    /// Publishers may park meanwhile, wake_parked() must be called once the mutex is released.
+    void combine_locked(data_t &data)
+    {
+        m_combining.store(true, std::memory_order_relaxed);
+        combine(data);
+        m_combining.store(false, std::memory_order_seq_cst);
+    }
+
+    /// @brief Apply all pending operations to given data, mutex must be held.
+    void combine(data_t &data)
+    {
+        for (Slot &slot : m_slots)
+        {
+            const std::uint32_t state = slot.state.load(std::memory_order_acquire);
+            if (state != Slot::PENDING && state != Slot::PARKED)
+                continue;
+            detail::CombinedOperation<data_t> &operation = *slot.operation;
+            try
+            {
+                operation.run(operation, data);
+            }
+            catch (...)
+            {
+                operation.error = std::current_exception();
+            }
+            // The publisher may return as soon as its operation is flagged done.
+            if (slot.state.exchange(Slot::DONE, std::memory_order_acq_rel) == Slot::PARKED)
+                detail::futex_wake_one(slot.state);
+        }
+    }
+
+    /// @brief Block until given slot's operation is applied, or no thread combines anymore.
+    void park(Slot &slot)
+    {
+        std::uint32_t state = Slot::PENDING;
+        if (!slot.state.compare_exchange_strong(state, Slot::PARKED, std::memory_order_seq_cst, std::memory_order_acquire))
+            return;
+        // Either the combining thread sees this slot parked when done, or this thread sees it done.
+        if (m_combining.load(std::memory_order_seq_cst))
+            detail::futex_wait(slot.state, Slot::PARKED);
+        state = Slot::PARKED;
+        slot.state.compare_exchange_strong(state, Slot::PENDING, std::memory_order_acquire, std::memory_order_acquire);
+    }
+
+    /// @brief Let publishers parked while operations were combined try to combine theirs.
+    void wake_parked()
+    {
+        for (Slot &slot : m_slots)
+        {
+            std::uint32_t state = Slot::PARKED;
+            if (slot.state.load(std::memory_order_seq_cst) == Slot::PARKED &&
+                slot.state.compare_exchange_strong(state, Slot::PENDING, std::memory_order_seq_cst, std::memory_order_relaxed))
+                detail::futex_wake_one(slot.state);
+        }
+    }
+
+    Mustex<data_t, M> m_mustex;
+    Slot m_slots[detail::COMBINING_SLOTS];
+    /// @brief Whether a thread is combining pending operations, publishers may then park.
+    std::atomic<bool> m_combining{false};
+};
+
+} // namespace bcx
+
+#endif // #ifndef BCX_COMBINING_MUSTEX_HPP
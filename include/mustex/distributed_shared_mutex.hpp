@@ -0,0 +1,189 @@
+#ifndef BCX_DISTRIBUTED_SHARED_MUTEX_HPP
+#define BCX_DISTRIBUTED_SHARED_MUTEX_HPP
+
+#include "mustex.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+namespace bcx
+{
+
+/// @brief Scalable reader-writer mutex for read-mostly data (a.k.a. big-reader lock).
+/// Readers register in one of several cache line padded slots, picked depending on calling thread,
+/// so that concurrent readers on different cores do not write to the same cache line.
+/// Writers are exclusive, and wait for every slot to be empty. Waiting readers and writers spin
+/// then yield, this mutex is hence intended for short critical sections.
+/// Meets the SharedTimedLockable requirements, and can be used as `Mustex<T, DistributedSharedMutex>`.
+/// As for any shared mutex, a shared lock must be released by the thread that acquired it.
+class DistributedSharedMutex
+{
+public:
+    /// @brief Create mutex with one slot per hardware thread.
+    DistributedSharedMutex()
+        : DistributedSharedMutex(std::thread::hardware_concurrency())
+    {
+    }
+
+    /// @brief Create mutex with given number of reader slots, rounded up to a power of two.
+    explicit DistributedSharedMutex(std::size_t slots)
+        : m_mask{round_up_pow2(slots) - 1}
+        , m_slots{new Slot[m_mask + 1]}
+        , m_writer{false}
+    {
+    }
+
+    DistributedSharedMutex(const DistributedSharedMutex &) = delete;
+    DistributedSharedMutex &operator=(const DistributedSharedMutex &) = delete;
+
+    void lock()
+    {
+        detail::Backoff backoff;
+        while (!try_acquire_writer())
+            backoff.pause();
+        backoff.reset();
+        while (has_readers())
+            backoff.pause();
+    }
+
+    bool try_lock()
+    {
+        if (!try_acquire_writer())
+            return false;
+        if (!has_readers())
+            return true;
+        m_writer.store(false, std::memory_order_release);
+        return false;
+    }
+
+    template<typename Rep, typename Period>
+    bool try_lock_for(const std::chrono::duration<Rep, Period> &d)
+    {
+        return try_lock_until(std::chrono::steady_clock::now() + d);
+    }
+
+    template<typename Clock, typename Duration>
+    bool try_lock_until(const std::chrono::time_point<Clock, Duration> &tp)
+    {
+        detail::Backoff backoff;
+        while (!try_acquire_writer())
+        {
+            if (Clock::now() >= tp)
+                return false;
+            backoff.pause();
+        }
+        backoff.reset();
+        while (has_readers())
+        {
+            if (Clock::now() >= tp)
+            {
+                m_writer.store(false, std::memory_order_release);
+                return false;
+            }
+            backoff.pause();
+        }
+        return true;
+    }
+
+    void unlock()
+    {
+        m_writer.store(false, std::memory_order_release);
+    }
+
+    void lock_shared()
+    {
+        Slot &slot = this_thread_slot();
+        detail::Backoff backoff;
+        while (!try_lock_shared(slot))
+            backoff.pause();
+    }
+
+    bool try_lock_shared()
+    {
+        return try_lock_shared(this_thread_slot());
+    }
+
+    template<typename Rep, typename Period>
+    bool try_lock_shared_for(const std::chrono::duration<Rep, Period> &d)
+    {
+        return try_lock_shared_until(std::chrono::steady_clock::now() + d);
+    }
+
+    template<typename Clock, typename Duration>
+    bool try_lock_shared_until(const std::chrono::time_point<Clock, Duration> &tp)
+    {
+        Slot &slot = this_thread_slot();
+        detail::Backoff backoff;
+        while (!try_lock_shared(slot))
+        {
+            if (Clock::now() >= tp)
+                return false;
+            backoff.pause();
+        }
+        return true;
+    }
+
+    void unlock_shared()
+    {
+        this_thread_slot().readers.fetch_sub(1, std::memory_order_release);
+    }
+
+private:
+    /// @brief Number of readers registered in a slot, alone on its cache line.
+    struct Slot
+    {
+        char padding_front[64];
+        std::atomic<std::size_t> readers{0};
+        char padding_back[64];
+    };
+
+    static std::size_t round_up_pow2(std::size_t value)
+    {
+        std::size_t result = 1;
+        while (result < value)
+            result <<= 1;
+        return result;
+    }
+
+    Slot &this_thread_slot()
+    {
+        return m_slots[detail::this_thread_index() & m_mask];
+    }
+
+    bool try_acquire_writer()
+    {
+        bool writer = false;
+        return !m_writer.load(std::memory_order_relaxed) && m_writer.compare_exchange_strong(writer, true, std::memory_order_seq_cst);
+    }
+
+    bool has_readers() const
+    {
+        for (std::size_t i = 0; i <= m_mask; ++i)
+            if (m_slots[i].readers.load(std::memory_order_seq_cst) != 0)
+                return true;
+        return false;
+    }
+
+    bool try_lock_shared(Slot &slot)
+    {
+        if (m_writer.load(std::memory_order_relaxed))
+            return false;
+        slot.readers.fetch_add(1, std::memory_order_seq_cst);
+        if (!m_writer.load(std::memory_order_seq_cst))
+            return true;
+        // A writer arrived meanwhile, let it go first.
+        slot.readers.fetch_sub(1, std::memory_order_release);
+        return false;
+    }
+
+    const std::size_t m_mask;
+    const std::unique_ptr<Slot[]> m_slots;
+    /// @brief Whether a writer owns or is acquiring the mutex.
+    std::atomic<bool> m_writer;
+};
+
+} // namespace bcx
+
+#endif // #ifndef BCX_DISTRIBUTED_SHARED_MUTEX_HPP
@@ -0,0 +1,116 @@
+#ifndef BCX_EVENTFD_LOCK_HPP
+#define BCX_EVENTFD_LOCK_HPP
+
+#include "async_mutex.hpp"
+
+#if defined(__linux__)
+#    define _MUSTEX_HAS_EVENTFD
+#    include <sys/eventfd.h>
+#    include <unistd.h>
+#    include <cerrno>
+#    include <system_error>
+#endif // #if defined(__linux__)
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+
+#ifdef _MUSTEX_HAS_EVENTFD
+namespace bcx
+{
+
+/// @brief Pending lock on a `Mustex<T, AsyncMutex>`, signalled through a Linux eventfd, for event
+/// loops which must never block.
+/// On construction, the registration queues up on the mutex as any other waiter. Its file
+/// descriptor becomes readable once the mutex is handed over to it, and can be watched by epoll or
+/// io_uring along with sockets. take() then completes the acquisition without blocking, and returns
+/// the usual handle. Destroying the registration before taking the handle gives up the lock, or
+/// the place in the queue. Only available on Linux, where `_MUSTEX_HAS_EVENTFD` is defined.
+/// @tparam U Type of the Mustex, const for read-only access.
+template<typename U>
+class EventfdLock : private detail::AsyncWaiter
+{
+public:
+    using handle_t = decltype(detail::adopt_awaited(std::declval<U &>()));
+
+    /// @brief Queue up for given Mustex, the descriptor being readable right away if it is available.
+    /// @throw std::system_error if the eventfd cannot be created.
+    explicit EventfdLock(U &mustex)
+        : m_owner(&mustex)
+        , m_fd(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC))
+    {
+        if (m_fd < 0)
+            throw std::system_error(errno, std::system_category(), "EventfdLock");
+        this->exclusive = !std::is_const<U>::value;
+        this->wake = &EventfdLock::signal;
+        if (mutex().acquire_or_enqueue(*this))
+            signal(*this);
+    }
+
+    EventfdLock(const EventfdLock &) = delete;
+    EventfdLock &operator=(const EventfdLock &) = delete;
+
+    ~EventfdLock()
+    {
+        if (!m_taken && !mutex().cancel(*this))
+        {
+            wait_signalled();
+            if (this->exclusive)
+                detail::proxy_mutex::unlock_write(mutex());
+            else
+                detail::proxy_mutex::unlock_read(mutex());
+        }
+        ::close(m_fd);
+    }
+
+    /// @brief Descriptor becoming readable once the mutex is handed over, not to be read directly.
+    int fd() const { return m_fd; }
+
+    /// @brief Take the handle on owned data, if the mutex was handed over. Never blocks.
+    /// @return Handle on owned data, empty if the descriptor is not readable yet or the handle was
+    ///         already taken.
+    detail::Optional<handle_t> take()
+    {
+        std::uint64_t value = 0;
+        if (m_taken || ::read(m_fd, &value, sizeof(value)) != static_cast<ssize_t>(sizeof(value)))
+            return {};
+        wait_signalled();
+        m_taken = true;
+        return detail::adopt_awaited(*m_owner);
+    }
+
+private:
+    typename std::remove_const<U>::type::mutex_t &mutex() const
+    {
+        return detail::MustexAccess::mutex(*m_owner);
+    }
+
+    static void signal(detail::AsyncWaiter &waiter)
+    {
+        EventfdLock &self = static_cast<EventfdLock &>(waiter);
+        const std::uint64_t one = 1;
+        while (::write(self.m_fd, &one, sizeof(one)) < 0 && errno == EINTR)
+            ;
+        // The registration may be destroyed as soon as it is flagged, waking an address no one
+        // waits on is harmless.
+        self.m_signalled.store(1, std::memory_order_release);
+        detail::futex_wake_one(self.m_signalled);
+    }
+
+    /// @brief Wait for signal() to be done with the registration, once it started signalling it.
+    void wait_signalled()
+    {
+        while (!m_signalled.load(std::memory_order_acquire))
+            detail::futex_wait(m_signalled, 0);
+    }
+
+    U *m_owner;
+    const int m_fd;
+    std::atomic<std::uint32_t> m_signalled{0};
+    bool m_taken = false;
+};
+
+} // namespace bcx
+#endif // #ifdef _MUSTEX_HAS_EVENTFD
+
+#endif // #ifndef BCX_EVENTFD_LOCK_HPP
@@ -0,0 +1,406 @@
+#ifndef BCX_LEFT_RIGHT_MUSTEX_HPP
+#define BCX_LEFT_RIGHT_MUSTEX_HPP
+
+#include "mustex.hpp"
+
+#include <atomic>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+namespace bcx
+{
+
+// Forward declares
+template<typename T, class M>
+class LeftRightMustex;
+
+namespace detail
+{
+/// @brief Number of readers of one version of a Left-Right instance, alone on its cache line.
+struct LeftRightReadIndicator
+{
+    char padding_front[64];
+    std::atomic<std::size_t> readers{0};
+    char padding_back[64];
+};
+} // namespace detail
+
+/// @brief Mutable access to LeftRightMustex data.
+/// Since every mutation is applied to both replicas of the data, mutations are given as callables
+/// to `apply()`, and replayed on the replica used by readers when the handle is dropped.
+/// @tparam T Type of data to be accessed.
+/// @tparam M Type of mutex serializing writers.
+template<typename T, class M>
+class LeftRightMustexHandle
+{
+public:
+    // Only parent LeftRightMustex can instantiate this class.
+    template<class MT, class MM>
+    friend class LeftRightMustex;
+
+    /// @brief The type of contained value, exposed for convenience.
+    using data_t = typename std::remove_cv<T>::type;
+
+    LeftRightMustexHandle() = delete;
+    LeftRightMustexHandle(const LeftRightMustexHandle &) = delete;
+    LeftRightMustexHandle(LeftRightMustexHandle &&other)
+        : m_owner{other.m_owner}
+        , m_first{other.m_first}
+        , m_last{other.m_last}
+    {
+        other.m_owner = nullptr;
+        other.m_first = nullptr;
+        other.m_last = nullptr;
+    }
+
+    LeftRightMustexHandle &operator=(const LeftRightMustexHandle &other) = delete;
+    LeftRightMustexHandle &operator=(LeftRightMustexHandle &&other)
+    {
+        unlock();
+        m_owner = other.m_owner;
+        other.m_owner = nullptr;
+        m_first = other.m_first;
+        other.m_first = nullptr;
+        m_last = other.m_last;
+        other.m_last = nullptr;
+        return *this;
+    }
+
+    ~LeftRightMustexHandle()
+    {
+        unlock();
+    }
+
+    /// @brief Apply given mutation to the replica not used by readers, and record it in order to
+    /// replay it on the other replica when this handle is dropped.
+    /// The mutation must give the same result when replayed, where it must not throw. If it throws
+    /// when first applied, it must leave the data unchanged : it is then not recorded, and the
+    /// exception is propagated. Otherwise replicas would differ once readers are switched.
+    /// @param f Callable accepting a `data_t &`, may be move-only.
+    template<typename F>
+    void apply(F f)
+    {
+        std::unique_ptr<detail::PostedCall<data_t, F>> mutation(new detail::PostedCall<data_t, F>(std::move(f)));
+        mutation->function(m_owner->writer_instance());
+        if (m_last)
+            m_last->next = mutation.get();
+        else
+            m_first = mutation.get();
+        m_last = mutation.release();
+    }
+
+    /// @brief Read data, including mutations applied through this handle.
+    const T &operator*() const
+    {
+        return m_owner->writer_instance();
+    }
+
+    /// @brief Read data, including mutations applied through this handle.
+    const T *operator->() const
+    {
+        return &m_owner->writer_instance();
+    }
+
+private:
+    LeftRightMustex<data_t, M> *m_owner;
+    /// @brief Applied mutations to replay, in order, linked by their `next` member.
+    detail::PostedMutation *m_first = nullptr;
+    detail::PostedMutation *m_last = nullptr;
+
+    /// @brief Create handle on ALREADY ACQUIRED writer mutex.
+    explicit LeftRightMustexHandle(LeftRightMustex<data_t, M> *owner)
+        : m_owner{owner}
+    {
+    }
+
+    void unlock()
+    {
+        if (!m_owner)
+            return;
+        m_owner->publish(m_first);
+        m_first = nullptr;
+        m_last = nullptr;
+        detail::proxy_mutex::unlock_write(m_owner->m_mutex);
+    }
+};
+
+/// @brief Read-only access to LeftRightMustex data.
+/// @tparam T Type of data to be accessed.
+/// @tparam M Type of mutex serializing writers.
+template<typename T, class M>
+class LeftRightMustexHandle<const T, M>
+{
+public:
+    // Only parent LeftRightMustex can instantiate this class.
+    template<class MT, class MM>
+    friend class LeftRightMustex;
+
+    /// @brief The type of contained value, exposed for convenience.
+    using data_t = typename std::remove_cv<T>::type;
+
+    LeftRightMustexHandle() = delete;
+    LeftRightMustexHandle(const LeftRightMustexHandle &) = delete;
+    LeftRightMustexHandle(LeftRightMustexHandle &&other)
+        : m_indicator{other.m_indicator}
+        , m_data{other.m_data}
+    {
+        other.m_indicator = nullptr;
+        other.m_data = nullptr;
+    }
+
+    LeftRightMustexHandle &operator=(const LeftRightMustexHandle &other) = delete;
+    LeftRightMustexHandle &operator=(LeftRightMustexHandle &&other)
+    {
+        unlock();
+        m_indicator = other.m_indicator;
+        other.m_indicator = nullptr;
+        m_data = other.m_data;
+        other.m_data = nullptr;
+        return *this;
+    }
+
+    ~LeftRightMustexHandle()
+    {
+        unlock();
+    }
+
+    const T &operator*() const
+    {
+        return *m_data;
+    }
+
+    const T *operator->() const
+    {
+        return m_data;
+    }
+
+private:
+    detail::LeftRightReadIndicator *m_indicator;
+    const T *m_data;
+
+    /// @brief Create handle on ALREADY ARRIVED reader.
+    LeftRightMustexHandle(detail::LeftRightReadIndicator *indicator, const T *data)
+        : m_indicator{indicator}
+        , m_data{data}
+    {
+    }
+
+    void unlock()
+    {
+        if (!m_indicator)
+            return;
+        m_indicator->readers.fetch_sub(1, std::memory_order_release);
+    }
+};
+
+/// @brief Data-owning Left-Right synchronization, with wait-free readers.
+/// The data is kept in two replicas : readers access one of them without ever waiting, while a
+/// writer mutates the other one. When the writer is done, readers are switched to the mutated
+/// replica, and mutations are replayed on the former one once its last reader is gone.
+/// @tparam T The type of data to be shared among threads, must be copy constructible.
+/// @tparam M Type of mutex serializing writers.
+template<class T, class M = std::timed_mutex>
+class LeftRightMustex
+{
+public:
+    /// @brief The type of contained value, exposed for convenience.
+    using data_t = typename std::remove_cv<T>::type;
+    /// @brief The type of mutex used, exposed for convenience.
+    using mutex_t = M;
+    /// @brief The type of handle used to access data.
+    using Handle = LeftRightMustexHandle<const data_t, M>;
+    /// @brief The type of handle used to access data mutably.
+    using HandleMut = LeftRightMustexHandle<data_t, M>;
+
+    template<typename... Args>
+    LeftRightMustex(Args &&...args)
+        : m_left(std::forward<Args>(args)...)
+        , m_right(m_left)
+        , m_read_side{0}
+        , m_version{0}
+        , m_mutex{}
+    {
+    }
+
+    LeftRightMustex(const LeftRightMustex &) = delete;
+    LeftRightMustex(LeftRightMustex &&other) = delete;
+    LeftRightMustex &operator=(const LeftRightMustex &other) = delete;
+    LeftRightMustex &operator=(LeftRightMustex &&other) = delete;
+
+    ~LeftRightMustex() = default;
+
+private:
+    using OptionalHandle = detail::Optional<Handle>;
+    using OptionalHandleMut = detail::Optional<HandleMut>;
+
+    const data_t &instance(unsigned side) const
+    {
+        return side ? m_right : m_left;
+    }
+
+    data_t &instance(unsigned side)
+    {
+        return side ? m_right : m_left;
+    }
+
+    /// @brief Replica not accessed by new readers, writer mutex must be held.
+    data_t &writer_instance()
+    {
+        return instance(1 - m_read_side.load(std::memory_order_relaxed));
+    }
+
+    /// @brief Wait for given read indicator to be empty.
+    static void wait_empty(const detail::LeftRightReadIndicator &indicator)
+    {
+        detail::Backoff backoff;
+        while (indicator.readers.load(std::memory_order_seq_cst) != 0)
+            backoff.pause();
+    }
+
+    /// @brief Switch readers to writer replica and replay mutations on the other one, writer mutex
+    /// must be held. Replayed mutations are destroyed.
+    /// @param mutations Mutations in order, linked by their `next` member.
+    void publish(detail::PostedMutation *mutations)
+    {
+        if (!mutations)
+            return;
+        const unsigned previous_side = m_read_side.load(std::memory_order_relaxed);
+        m_read_side.store(1 - previous_side, std::memory_order_seq_cst);
+
+        // Make sure no reader can still access previous side, whatever version it arrived on.
+        const unsigned previous_version = m_version.load(std::memory_order_relaxed);
+        wait_empty(m_indicators[1 - previous_version]);
+        m_version.store(1 - previous_version, std::memory_order_seq_cst);
+        wait_empty(m_indicators[previous_version]);
+
+        data_t &replica = instance(previous_side);
+        while (mutations)
+        {
+            detail::PostedMutation *next = mutations->next;
+            mutations->apply(*mutations, &replica);
+            mutations = next;
+        }
+    }
+
+    OptionalHandle make_optional() const
+    {
+        return lock();
+    }
+
+    OptionalHandleMut make_optional_mut()
+    {
+        return HandleMut(this);
+    }
+
+public:
+    /// @brief Lock data for read-only access. Wait-free, never blocked by writers.
+    /// @return Handle on owned data.
+    Handle lock() const
+    {
+        detail::LeftRightReadIndicator &indicator = m_indicators[m_version.load(std::memory_order_seq_cst)];
+        indicator.readers.fetch_add(1, std::memory_order_seq_cst);
+        return Handle(&indicator, &instance(m_read_side.load(std::memory_order_seq_cst)));
+    }
+
+    /// @brief Lock data for read-only access, provided for Mustex parity.
+    /// @return Handle on owned data, always available.
+    OptionalHandle try_lock() const
+    {
+        return make_optional();
+    }
+
+    /// @brief Lock data for read-only access, provided for Mustex parity.
+    /// @return Handle on owned data, always available.
+    OptionalHandle lock(std::try_to_lock_t) const
+    {
+        return make_optional();
+    }
+
+    /// @brief Lock data for read-only access, provided for Mustex parity.
+    /// @return Handle on owned data, always available.
+    template<typename Rep, typename Period>
+    OptionalHandle try_lock_for(const std::chrono::duration<Rep, Period> &) const
+    {
+        return make_optional();
+    }
+
+    /// @brief Lock data for read-only access, provided for Mustex parity.
+    /// @return Handle on owned data, always available.
+    template<typename Clock, typename Duration>
+    OptionalHandle try_lock_until(const std::chrono::time_point<Clock, Duration> &) const
+    {
+        return make_optional();
+    }
+
+    /// @brief Lock data for write access. Readers are not blocked, and see mutations once the
+    /// handle is dropped.
+    /// @return Handle applying mutations to owned data.
+    HandleMut lock_mut()
+    {
+        detail::proxy_mutex::lock_write(m_mutex);
+        return HandleMut(this);
+    }
+
+    /// @brief Try to lock data for write access.
+    /// @return Handle applying mutations to owned data if available. Check before use.
+    OptionalHandleMut try_lock_mut()
+    {
+        if (detail::proxy_mutex::try_lock_write(m_mutex))
+            return make_optional_mut();
+        return {};
+    }
+
+    /// @brief Try to lock data for write access.
+    /// @return Handle applying mutations to owned data if available. Check before use.
+    OptionalHandleMut lock_mut(std::try_to_lock_t)
+    {
+        return try_lock_mut();
+    }
+
+    /// @brief Try to lock data for write access for given amount of time.
+    /// @param d Amount of time to try acquiring access. Returns if exceeded.
+    /// @return Handle applying mutations to owned data if available during given amount of time. Check before use.
+    template<typename Rep, typename Period>
+    OptionalHandleMut try_lock_mut_for(const std::chrono::duration<Rep, Period> &d)
+    {
+        if (detail::proxy_mutex::try_lock_write_for(m_mutex, d))
+            return make_optional_mut();
+        return {};
+    }
+
+    /// @brief Try to lock data for write access until given instant is reached.
+    /// @param tp Deadline for access to be granted. Returns if reached.
+    /// @return Handle applying mutations to owned data if available before deadline. Check before use.
+    template<typename Clock, typename Duration>
+    OptionalHandleMut try_lock_mut_until(const std::chrono::time_point<Clock, Duration> &tp)
+    {
+        if (detail::proxy_mutex::try_lock_write_until(m_mutex, tp))
+            return make_optional_mut();
+        return {};
+    }
+
+    /// @brief Apply a single mutation to owned data, shorthand for `lock_mut().apply(f)`.
+    /// @param f Callable accepting a `data_t &`, see LeftRightMustexHandle::apply().
+    template<typename F>
+    void modify(F f)
+    {
+        lock_mut().apply(std::move(f));
+    }
+
+private:
+    friend HandleMut;
+
+    data_t m_left;
+    data_t m_right;
+    /// @brief Replica accessed by new readers.
+    std::atomic<unsigned> m_read_side;
+    /// @brief Read indicator new readers arrive on.
+    std::atomic<unsigned> m_version;
+    mutable detail::LeftRightReadIndicator m_indicators[2];
+    M m_mutex;
+};
+
+} // namespace bcx
+
+#endif // #ifndef BCX_LEFT_RIGHT_MUSTEX_HPP
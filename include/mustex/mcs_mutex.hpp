@@ -0,0 +1,315 @@
+#ifndef BCX_MCS_MUTEX_HPP
+#define BCX_MCS_MUTEX_HPP
+
+#include "mustex.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace bcx
+{
+
+namespace detail
+{
+/// @brief Queue node of a thread waiting for, or holding, an McsMutex. Each waiter spins on its own
+/// node, alone on its cache line.
+struct McsNode
+{
+    static constexpr std::uint32_t WAITING = 0;
+    static constexpr std::uint32_t PARKED = 1;
+    static constexpr std::uint32_t GRANTED = 2;
+
+    char padding_front[64];
+    std::atomic<McsNode *> next{nullptr};
+    std::atomic<std::uint32_t> state{WAITING};
+    McsNode *free_next = nullptr;
+    char padding_back[64];
+};
+
+/// @brief Thread local free list of queue nodes, a thread needing one node per mutex it holds or
+/// waits for at the same time.
+class McsNodePool
+{
+public:
+    ~McsNodePool()
+    {
+        while (m_free)
+        {
+            McsNode *node = m_free;
+            m_free = node->free_next;
+            delete node;
+        }
+    }
+
+    static McsNode *acquire()
+    {
+        McsNodePool &pool = instance();
+        McsNode *node = pool.m_free;
+        if (node)
+            pool.m_free = node->free_next;
+        else
+            node = new McsNode;
+        node->next.store(nullptr, std::memory_order_relaxed);
+        node->state.store(McsNode::WAITING, std::memory_order_relaxed);
+        return node;
+    }
+
+    static void release(McsNode *node)
+    {
+        McsNodePool &pool = instance();
+        node->free_next = pool.m_free;
+        pool.m_free = node;
+    }
+
+private:
+    McsNode *m_free = nullptr;
+
+    static McsNodePool &instance()
+    {
+        static thread_local McsNodePool pool;
+        return pool;
+    }
+};
+} // namespace detail
+
+/// @brief Exclusive queue lock (Mellor-Crummey and Scott), for fair locking under heavy contention.
+/// Waiting threads queue up in arrival order, each spinning then parking on its own node, and the
+/// mutex is handed over to the next queued thread on unlock. Handing the mutex over only touches
+/// the cache line of the next thread, instead of every waiting thread spinning on the same one.
+/// Timed acquisitions do not queue up, they poll the mutex until free or the deadline is reached,
+/// hence may be overtaken by queued ones.
+/// Meets the TimedLockable requirements, and can be used as `Mustex<T, McsMutex>`. Readers are
+/// then exclusive too, see McsSharedMutex to allow simultaneous readers.
+class McsMutex
+{
+public:
+    McsMutex() = default;
+    McsMutex(const McsMutex &) = delete;
+    McsMutex &operator=(const McsMutex &) = delete;
+
+    void lock()
+    {
+        detail::McsNode *node = detail::McsNodePool::acquire();
+        detail::McsNode *previous = m_tail.exchange(node, std::memory_order_acq_rel);
+        if (previous)
+        {
+            previous->next.store(node, std::memory_order_release);
+            wait_granted(*node);
+        }
+        m_owner = node;
+    }
+
+    bool try_lock()
+    {
+        if (m_tail.load(std::memory_order_relaxed))
+            return false;
+        detail::McsNode *node = detail::McsNodePool::acquire();
+        detail::McsNode *expected = nullptr;
+        if (!m_tail.compare_exchange_strong(expected, node, std::memory_order_acquire, std::memory_order_relaxed))
+        {
+            detail::McsNodePool::release(node);
+            return false;
+        }
+        m_owner = node;
+        return true;
+    }
+
+    template<typename Rep, typename Period>
+    bool try_lock_for(const std::chrono::duration<Rep, Period> &d)
+    {
+        return try_lock_until(std::chrono::steady_clock::now() + d);
+    }
+
+    template<typename Clock, typename Duration>
+    bool try_lock_until(const std::chrono::time_point<Clock, Duration> &tp)
+    {
+        detail::Backoff backoff;
+        while (!try_lock())
+        {
+            if (Clock::now() >= tp)
+                return false;
+            backoff.pause();
+        }
+        return true;
+    }
+
+    void unlock()
+    {
+        detail::McsNode *node = m_owner;
+        detail::McsNode *next = node->next.load(std::memory_order_acquire);
+        if (!next)
+        {
+            detail::McsNode *expected = node;
+            if (m_tail.compare_exchange_strong(expected, nullptr, std::memory_order_release, std::memory_order_relaxed))
+            {
+                detail::McsNodePool::release(node);
+                return;
+            }
+            // Next thread is queuing up, but did not link itself yet.
+            detail::Backoff backoff;
+            while (!(next = node->next.load(std::memory_order_acquire)))
+                backoff.pause();
+        }
+        if (next->state.exchange(detail::McsNode::GRANTED, std::memory_order_release) == detail::McsNode::PARKED)
+            detail::futex_wake_one(next->state);
+        detail::McsNodePool::release(node);
+    }
+
+private:
+    static void wait_granted(detail::McsNode &node)
+    {
+        detail::Backoff backoff;
+        while (node.state.load(std::memory_order_acquire) == detail::McsNode::WAITING)
+        {
+            if (backoff.is_spinning())
+            {
+                backoff.pause();
+                continue;
+            }
+            std::uint32_t expected = detail::McsNode::WAITING;
+            if (node.state.compare_exchange_strong(expected, detail::McsNode::PARKED, std::memory_order_relaxed))
+                while (node.state.load(std::memory_order_acquire) == detail::McsNode::PARKED)
+                    detail::futex_wait(node.state, detail::McsNode::PARKED);
+        }
+    }
+
+    /// @brief Last queued node, nullptr if unlocked.
+    std::atomic<detail::McsNode *> m_tail{nullptr};
+    /// @brief Node of the thread holding the mutex, only accessed by this thread.
+    detail::McsNode *m_owner = nullptr;
+};
+
+/// @brief Reader-writer queue lock, admitting readers and writers in arrival order.
+/// Readers and writers queue up in an McsMutex. A reader only holds it long enough to register
+/// itself, so that consecutive readers are admitted together, while a writer holds it until
+/// unlocked, after waiting for registered readers to leave. Threads arriving after a writer hence
+/// wait for it, and writers cannot be starved.
+/// Meets the SharedTimedLockable requirements, and can be used as `Mustex<T, McsSharedMutex>`.
+class McsSharedMutex
+{
+public:
+    McsSharedMutex() = default;
+    McsSharedMutex(const McsSharedMutex &) = delete;
+    McsSharedMutex &operator=(const McsSharedMutex &) = delete;
+
+    void lock()
+    {
+        m_queue.lock();
+        wait_readers<std::chrono::steady_clock, std::chrono::steady_clock::duration>(nullptr);
+    }
+
+    bool try_lock()
+    {
+        if (!m_queue.try_lock())
+            return false;
+        if (m_readers.load(std::memory_order_acquire) == 0)
+            return true;
+        m_queue.unlock();
+        return false;
+    }
+
+    template<typename Rep, typename Period>
+    bool try_lock_for(const std::chrono::duration<Rep, Period> &d)
+    {
+        return try_lock_until(std::chrono::steady_clock::now() + d);
+    }
+
+    template<typename Clock, typename Duration>
+    bool try_lock_until(const std::chrono::time_point<Clock, Duration> &tp)
+    {
+        if (!m_queue.try_lock_until(tp))
+            return false;
+        if (wait_readers(&tp))
+            return true;
+        m_queue.unlock();
+        return false;
+    }
+
+    void unlock()
+    {
+        m_queue.unlock();
+    }
+
+    void lock_shared()
+    {
+        m_queue.lock();
+        m_readers.fetch_add(1, std::memory_order_relaxed);
+        m_queue.unlock();
+    }
+
+    bool try_lock_shared()
+    {
+        if (!m_queue.try_lock())
+            return false;
+        m_readers.fetch_add(1, std::memory_order_relaxed);
+        m_queue.unlock();
+        return true;
+    }
+
+    template<typename Rep, typename Period>
+    bool try_lock_shared_for(const std::chrono::duration<Rep, Period> &d)
+    {
+        return try_lock_shared_until(std::chrono::steady_clock::now() + d);
+    }
+
+    template<typename Clock, typename Duration>
+    bool try_lock_shared_until(const std::chrono::time_point<Clock, Duration> &tp)
+    {
+        if (!m_queue.try_lock_until(tp))
+            return false;
+        m_readers.fetch_add(1, std::memory_order_relaxed);
+        m_queue.unlock();
+        return true;
+    }
+
+    void unlock_shared()
+    {
+        // Last reader out wakes the writer up, no other reader can come in meanwhile.
+        if (m_readers.fetch_sub(1, std::memory_order_release) == (WRITER_WAITING | 1))
+        {
+            m_readers.fetch_and(~WRITER_WAITING, std::memory_order_release);
+            detail::futex_wake_one(m_readers);
+        }
+    }
+
+private:
+    static constexpr std::uint32_t WRITER_WAITING = 1u << 31;
+
+    /// @brief Wait for registered readers to leave, queue must be held.
+    /// @return False if the deadline, if any, was reached first.
+    template<typename Clock, typename Duration>
+    bool wait_readers(const std::chrono::time_point<Clock, Duration> *tp)
+    {
+        detail::Backoff backoff;
+        std::uint32_t readers;
+        while ((readers = m_readers.load(std::memory_order_acquire)) != 0)
+        {
+            if (backoff.is_spinning())
+            {
+                backoff.pause();
+                continue;
+            }
+            if (!(readers & WRITER_WAITING) && !m_readers.compare_exchange_weak(readers, readers | WRITER_WAITING, std::memory_order_relaxed))
+                continue;
+            if (!tp)
+            {
+                detail::futex_wait(m_readers, readers | WRITER_WAITING);
+            }
+            else if (!detail::futex_wait_until(m_readers, readers | WRITER_WAITING, *tp))
+            {
+                m_readers.fetch_and(~WRITER_WAITING, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        return true;
+    }
+
+    McsMutex m_queue;
+    /// @brief Number of registered readers, and whether the writer is parked until they leave.
+    std::atomic<std::uint32_t> m_readers{0};
+};
+
+} // namespace bcx
+
+#endif // #ifndef BCX_MCS_MUTEX_HPP
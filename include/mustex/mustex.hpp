@@ -35,29 +35,743 @@
 
 #ifdef _MUSTEX_HAS_OPTIONAL
 #    include <optional>
-#else // #ifdef _MUSTEX_HAS_OPTIONAL
-#    include <memory>
 #endif // #ifdef _MUSTEX_HAS_OPTIONAL
 
 #ifdef _MUSTEX_HAS_SHARED_MUTEX
 #    include <shared_mutex>
 #endif // #ifdef _MUSTEX_HAS_SHARED_MUTEX
 
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+#    include <intrin.h>
+#endif // #if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+
+#if defined(__linux__)
+#    define _MUSTEX_HAS_FUTEX
+#    include <linux/futex.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#    include <ctime>
+#else // #if defined(__linux__)
+#    include <condition_variable>
+#endif // #if defined(__linux__)
+
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
 #include <mutex>
+#include <new>
+#include <thread>
 #include <utility>
 
 namespace bcx
 {
 
+/// @brief Tag type selecting address-ordered acquisition in bcx::lock_mut() and bcx::lock(), or
+/// rank-ordered acquisition if all mutexes are ranked, see bcx::Ranked.
+struct ordered_lock_t
+{
+};
+
+/// @brief Acquire mutexes in a single blocking pass, in order of their addresses, rather than with
+/// the try-and-back-off algorithm of std::lock(). Threads locking several mutexes at once then
+/// always lock them in the same order, hence cannot deadlock, and never release a mutex they
+/// acquired to retry. Unordered acquisitions of the same mutexes remain prone to deadlocks.
+constexpr ordered_lock_t ordered_lock{};
+
 // Forward declares
 template<typename T, class M>
 class Mustex;
+template<typename T, class M, class O = Mustex<typename std::remove_cv<T>::type, M>>
+class MustexHandle;
+
+namespace detail
+{
+#ifdef _MUSTEX_HAS_OPTIONAL
+/// @brief Type returned by try-lock methods, empty if the lock could not be acquired.
+template<typename T>
+using Optional = std::optional<T>;
+#else // #ifdef _MUSTEX_HAS_OPTIONAL
+/// @brief Minimal std::optional replacement for move-only values, so that try-lock methods do not
+/// allocate before C++17. Empty if the lock could not be acquired.
+template<typename T>
+class Optional
+{
+public:
+    Optional()
+        : m_engaged{false}
+    {
+    }
+
+    Optional(T &&value)
+        : m_engaged{true}
+    {
+        new (&m_value) T(std::move(value));
+    }
+
+    Optional(const Optional &) = delete;
+    Optional(Optional &&other)
+        : m_engaged{other.m_engaged}
+    {
+        if (m_engaged)
+            new (&m_value) T(std::move(other.m_value));
+    }
+
+    Optional &operator=(const Optional &) = delete;
+    Optional &operator=(Optional &&other)
+    {
+        if (this == &other)
+            return *this;
+        reset();
+        if (other.m_engaged)
+        {
+            new (&m_value) T(std::move(other.m_value));
+            m_engaged = true;
+        }
+        return *this;
+    }
+
+    ~Optional()
+    {
+        reset();
+    }
+
+    explicit operator bool() const { return m_engaged; }
+    bool has_value() const { return m_engaged; }
+
+    T &operator*() { return m_value; }
+    const T &operator*() const { return m_value; }
+    T *operator->() { return std::addressof(m_value); }
+    const T *operator->() const { return std::addressof(m_value); }
+
+    void reset()
+    {
+        if (!m_engaged)
+            return;
+        m_value.~T();
+        m_engaged = false;
+    }
+
+private:
+    union
+    {
+        T m_value;
+    };
+    bool m_engaged;
+};
+#endif // #ifdef _MUSTEX_HAS_OPTIONAL
+
+/// @brief Vector storing up to N elements inline, for move-only values such as handles, so that
+/// locking a small number of Mustex does not allocate. Grows on the heap beyond.
+template<typename T, std::size_t N>
+class SmallVector
+{
+public:
+    SmallVector() {}
+
+    SmallVector(const SmallVector &) = delete;
+    SmallVector(SmallVector &&other)
+    {
+        move_from(other);
+    }
+
+    SmallVector &operator=(const SmallVector &) = delete;
+    SmallVector &operator=(SmallVector &&other)
+    {
+        if (this == &other)
+            return *this;
+        clear();
+        release();
+        move_from(other);
+        return *this;
+    }
+
+    ~SmallVector()
+    {
+        clear();
+        release();
+    }
+
+    std::size_t size() const { return m_size; }
+    bool empty() const { return m_size == 0; }
+
+    T *data() { return m_heap ? m_heap : m_inline; }
+    const T *data() const { return m_heap ? m_heap : m_inline; }
+    T *begin() { return data(); }
+    const T *begin() const { return data(); }
+    T *end() { return data() + m_size; }
+    const T *end() const { return data() + m_size; }
+    T &operator[](std::size_t i) { return data()[i]; }
+    const T &operator[](std::size_t i) const { return data()[i]; }
+
+    void reserve(std::size_t capacity)
+    {
+        if (capacity <= m_capacity)
+            return;
+        T *heap = static_cast<T *>(::operator new(capacity * sizeof(T)));
+        T *old = data();
+        for (std::size_t i = 0; i < m_size; ++i)
+        {
+            new (heap + i) T(std::move(old[i]));
+            old[i].~T();
+        }
+        release();
+        m_heap = heap;
+        m_capacity = capacity;
+    }
+
+    void push_back(T &&value)
+    {
+        if (m_size == m_capacity)
+            reserve(m_capacity * 2);
+        new (data() + m_size) T(std::move(value));
+        ++m_size;
+    }
+
+    void clear()
+    {
+        T *elements = data();
+        for (std::size_t i = 0; i < m_size; ++i)
+            elements[i].~T();
+        m_size = 0;
+    }
+
+private:
+    /// @brief Free heap storage, elements must have been destroyed or moved.
+    void release()
+    {
+        if (!m_heap)
+            return;
+        ::operator delete(m_heap);
+        m_heap = nullptr;
+        m_capacity = N;
+    }
+
+    /// @brief Take elements of other vector, left empty, this one having no storage of its own.
+    void move_from(SmallVector &other)
+    {
+        if (other.m_heap)
+        {
+            m_heap = other.m_heap;
+            m_capacity = other.m_capacity;
+            m_size = other.m_size;
+            other.m_heap = nullptr;
+            other.m_capacity = N;
+            other.m_size = 0;
+            return;
+        }
+        for (std::size_t i = 0; i < other.m_size; ++i)
+            new (m_inline + i) T(std::move(other.m_inline[i]));
+        m_size = other.m_size;
+        other.clear();
+    }
+
+    T *m_heap = nullptr;
+    std::size_t m_size = 0;
+    std::size_t m_capacity = N;
+    union
+    {
+        T m_inline[N];
+    };
+};
+
+/// @brief Hint the processor that the calling thread is in a spin-wait loop.
+inline void cpu_relax()
+{
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+    _mm_pause();
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__i386__) || defined(__x86_64__))
+    __builtin_ia32_pause();
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__aarch64__) || defined(__arm__))
+    __asm__ __volatile__("yield");
+#endif
+}
+
+/// @brief Exponential backoff for spin-wait loops.
+/// Spins for twice as long on each call, then yields to the scheduler once the limit is reached,
+/// so that a preempted thread the caller is waiting for gets a chance to run.
+class Backoff
+{
+public:
+    void pause()
+    {
+        if (m_step < SPIN_LIMIT)
+        {
+            for (unsigned i = 0; i < (1u << m_step); ++i)
+                cpu_relax();
+            ++m_step;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+
+    /// @brief Whether next call to pause() still spins instead of yielding.
+    bool is_spinning() const { return m_step < SPIN_LIMIT; }
+
+    void reset() { m_step = 0; }
+
+private:
+    static constexpr unsigned SPIN_LIMIT = 7;
+    unsigned m_step = 0;
+};
+
+/// @brief Small integer identifying calling thread, assigned in a round-robin manner on first call.
+inline std::size_t this_thread_index()
+{
+    static std::atomic<std::size_t> next{0};
+    static thread_local std::size_t index = next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+#ifdef _MUSTEX_HAS_FUTEX
+static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t), "Futex word must be a plain 32 bits integer");
+
+inline void futex_call(std::atomic<std::uint32_t> &word, int op, std::uint32_t value, const timespec *timeout)
+{
+    static_cast<void>(syscall(SYS_futex, reinterpret_cast<std::uint32_t *>(&word), op, value, timeout, nullptr, 0));
+}
+#else // #ifdef _MUSTEX_HAS_FUTEX
+/// @brief Where threads waiting on a word park, shared by all words hashing to the same bucket.
+struct ParkingBucket
+{
+    std::mutex mutex;
+    std::condition_variable condition;
+};
+
+inline ParkingBucket &parking_bucket(const void *address)
+{
+    static ParkingBucket buckets[64];
+    return buckets[(reinterpret_cast<std::uintptr_t>(address) >> 4) % 64];
+}
+#endif // #ifdef _MUSTEX_HAS_FUTEX
+
+/// @brief Block calling thread as long as `word` holds `expected`, or until woken up.
+/// Like a futex, may return spuriously, callers must check the word again.
+inline void futex_wait(std::atomic<std::uint32_t> &word, std::uint32_t expected)
+{
+#ifdef _MUSTEX_HAS_FUTEX
+    futex_call(word, FUTEX_WAIT_PRIVATE, expected, nullptr);
+#else // #ifdef _MUSTEX_HAS_FUTEX
+    ParkingBucket &bucket = parking_bucket(&word);
+    std::unique_lock<std::mutex> lock(bucket.mutex);
+    if (word.load(std::memory_order_relaxed) == expected)
+        bucket.condition.wait(lock);
+#endif // #ifdef _MUSTEX_HAS_FUTEX
+}
+
+/// @brief Same as futex_wait(), returning after given amount of time at the latest.
+inline void futex_wait_for(std::atomic<std::uint32_t> &word, std::uint32_t expected, std::chrono::nanoseconds timeout)
+{
+#ifdef _MUSTEX_HAS_FUTEX
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+    timespec ts;
+    ts.tv_sec = static_cast<decltype(ts.tv_sec)>(seconds.count());
+    ts.tv_nsec = static_cast<decltype(ts.tv_nsec)>((timeout - seconds).count());
+    futex_call(word, FUTEX_WAIT_PRIVATE, expected, &ts);
+#else // #ifdef _MUSTEX_HAS_FUTEX
+    ParkingBucket &bucket = parking_bucket(&word);
+    std::unique_lock<std::mutex> lock(bucket.mutex);
+    if (word.load(std::memory_order_relaxed) == expected)
+        bucket.condition.wait_for(lock, timeout);
+#endif // #ifdef _MUSTEX_HAS_FUTEX
+}
+
+/// @brief Same as futex_wait(), returning once given instant is reached at the latest.
+/// @return False if the deadline was already reached, in which case the thread did not block.
+template<typename Clock, typename Duration>
+inline bool futex_wait_until(
+    std::atomic<std::uint32_t> &word,
+    std::uint32_t expected,
+    const std::chrono::time_point<Clock, Duration> &tp
+)
+{
+    const auto now = Clock::now();
+    if (now >= tp)
+        return false;
+    futex_wait_for(word, expected, std::chrono::duration_cast<std::chrono::nanoseconds>(tp - now));
+    return true;
+}
+
+/// @brief Wake up one thread blocked on `word`, which must have been modified beforehand.
+inline void futex_wake_one(std::atomic<std::uint32_t> &word)
+{
+#ifdef _MUSTEX_HAS_FUTEX
+    futex_call(word, FUTEX_WAKE_PRIVATE, 1, nullptr);
+#else // #ifdef _MUSTEX_HAS_FUTEX
+    // Buckets are shared among words, the woken thread may not be waiting on this one.
+    ParkingBucket &bucket = parking_bucket(&word);
+    std::lock_guard<std::mutex> lock(bucket.mutex);
+    bucket.condition.notify_all();
+#endif // #ifdef _MUSTEX_HAS_FUTEX
+}
+
+/// @brief Wake up all threads blocked on `word`, which must have been modified beforehand.
+inline void futex_wake_all(std::atomic<std::uint32_t> &word)
+{
+#ifdef _MUSTEX_HAS_FUTEX
+    futex_call(word, FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr);
+#else // #ifdef _MUSTEX_HAS_FUTEX
+    ParkingBucket &bucket = parking_bucket(&word);
+    std::lock_guard<std::mutex> lock(bucket.mutex);
+    bucket.condition.notify_all();
+#endif // #ifdef _MUSTEX_HAS_FUTEX
+}
+
+} // namespace detail
+
+/// @brief Which threads a BasicSharedFutexMutex lets in first when both readers and writers wait.
+enum class SharedLockPolicy
+{
+    /// @brief Readers come in as long as no writer holds the mutex, writers may be starved.
+    PreferReaders,
+    /// @brief Waiting writers hold new readers back, readers may be starved.
+    PreferWriters,
+    /// @brief Readers and writers take turns: waiting writers hold new readers back, and readers
+    /// waiting when a writer unlocks are let in before the next writer.
+    PhaseFair,
+};
+
+/// @brief Compact reader-writer mutex, holding its whole state in a single 32 bits word.
+/// Uncontended acquisitions are a single compare-and-swap. Contended threads spin shortly, then
+/// park on the word (with a futex on Linux). Up to 65535 simultaneous readers, further ones wait for
+/// some to leave, and 4095 parked ones.
+/// One of the readers may hold the mutex for upgrade, excluding other upgraders but not readers, so
+/// that it can later atomically become a writer. A writer can likewise atomically become a reader.
+/// Meets the SharedTimedLockable, UpgradeLockable and Downgradable requirements.
+/// @tparam P Policy deciding which threads come in first when both readers and writers wait.
+template<SharedLockPolicy P>
+class BasicSharedFutexMutex
+{
+public:
+    BasicSharedFutexMutex() = default;
+    BasicSharedFutexMutex(const BasicSharedFutexMutex &) = delete;
+    BasicSharedFutexMutex &operator=(const BasicSharedFutexMutex &) = delete;
+
+    void lock()
+    {
+        if (!try_lock())
+            lock_slow<std::chrono::steady_clock, std::chrono::steady_clock::duration>(nullptr);
+    }
+
+    bool try_lock()
+    {
+        std::uint32_t state = m_state.load(std::memory_order_relaxed);
+        while (!(state & (WRITER | READERS)))
+            if (m_state.compare_exchange_weak(state, state | WRITER, std::memory_order_acquire, std::memory_order_relaxed))
+                return true;
+        return false;
+    }
+
+    template<typename Rep, typename Period>
+    bool try_lock_for(const std::chrono::duration<Rep, Period> &d)
+    {
+        return try_lock_until(std::chrono::steady_clock::now() + d);
+    }
+
+    template<typename Clock, typename Duration>
+    bool try_lock_until(const std::chrono::time_point<Clock, Duration> &tp)
+    {
+        return try_lock() || lock_slow(&tp);
+    }
+
+    void unlock()
+    {
+        std::uint32_t state = m_state.load(std::memory_order_relaxed);
+        while (!m_state.compare_exchange_weak(state, unlocked_state(state), std::memory_order_release, std::memory_order_relaxed))
+            ;
+        if (state & (WRITERS_WAITING | PARKED_READERS))
+            detail::futex_wake_all(m_state);
+    }
+
+    void lock_shared()
+    {
+        if (!try_lock_shared())
+            lock_shared_slow<std::chrono::steady_clock, std::chrono::steady_clock::duration>(nullptr);
+    }
+
+    bool try_lock_shared()
+    {
+        std::uint32_t state = m_state.load(std::memory_order_relaxed);
+        while (reader_may_enter(state))
+            if (m_state.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                return true;
+        return false;
+    }
+
+    template<typename Rep, typename Period>
+    bool try_lock_shared_for(const std::chrono::duration<Rep, Period> &d)
+    {
+        return try_lock_shared_until(std::chrono::steady_clock::now() + d);
+    }
+
+    template<typename Clock, typename Duration>
+    bool try_lock_shared_until(const std::chrono::time_point<Clock, Duration> &tp)
+    {
+        return try_lock_shared() || lock_shared_slow(&tp);
+    }
+
+    void unlock_shared()
+    {
+        // Last reader out, but a waiting upgrader, wakes waiting writers and upgrader up.
+        const std::uint32_t state = m_state.fetch_sub(1, std::memory_order_release);
+        const std::uint32_t remaining = (state & READERS) - 1;
+        if ((state & WRITERS_WAITING) && remaining == ((state & UPGRADER) ? 1u : 0u))
+            detail::futex_wake_all(m_state);
+    }
+
+    /// @brief Lock for upgrade: as a reader, but excluding other upgraders.
+    void lock_upgrade()
+    {
+        if (!try_lock_upgrade())
+            lock_upgrade_slow();
+    }
+
+    bool try_lock_upgrade()
+    {
+        std::uint32_t state = m_state.load(std::memory_order_relaxed);
+        while (reader_may_enter(state) && !(state & UPGRADER))
+            if (m_state.compare_exchange_weak(state, (state | UPGRADER) + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                return true;
+        return false;
+    }
+
+    void unlock_upgrade()
+    {
+        // Waiting upgraders wait for this one, and waiting writers may wait for this reader only.
+        std::uint32_t state = m_state.load(std::memory_order_relaxed);
+        while (!m_state.compare_exchange_weak(state, (state & ~(UPGRADER | WRITERS_WAITING)) - 1, std::memory_order_release, std::memory_order_relaxed))
+            ;
+        if (state & WRITERS_WAITING)
+            detail::futex_wake_all(m_state);
+    }
+
+    /// @brief Atomically turn upgrade lock into exclusive lock, once other readers left. New readers
+    /// are held back meanwhile, unless readers are preferred.
+    void unlock_upgrade_and_lock()
+    {
+        detail::Backoff backoff;
+        std::uint32_t state = m_state.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            if ((state & READERS) == 1)
+            {
+                if (m_state.compare_exchange_weak(state, (state & ~(UPGRADER | READERS)) | WRITER, std::memory_order_acquire, std::memory_order_relaxed))
+                    return;
+                continue;
+            }
+            if (backoff.is_spinning())
+            {
+                backoff.pause();
+                state = m_state.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (!(state & WRITERS_WAITING) && !m_state.compare_exchange_weak(state, state | WRITERS_WAITING, std::memory_order_relaxed))
+                continue;
+            detail::futex_wait(m_state, state | WRITERS_WAITING);
+            state = m_state.load(std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief Atomically turn exclusive lock into shared lock, letting waiting readers in as unlock()
+    /// would.
+    void unlock_and_lock_shared()
+    {
+        std::uint32_t state = m_state.load(std::memory_order_relaxed);
+        while (!m_state.compare_exchange_weak(state, unlocked_state(state) + 1, std::memory_order_release, std::memory_order_relaxed))
+            ;
+        if (state & (WRITERS_WAITING | PARKED_READERS))
+            detail::futex_wake_all(m_state);
+    }
+
+private:
+    static constexpr std::uint32_t WRITER = 1u << 31;
+    static constexpr std::uint32_t WRITERS_WAITING = 1u << 30;
+    /// @brief Flipped each time a writer lets parked readers in, so that they know they were.
+    static constexpr std::uint32_t GENERATION = 1u << 29;
+    /// @brief Set while one of the readers holds the mutex for upgrade.
+    static constexpr std::uint32_t UPGRADER = 1u << 28;
+    static constexpr std::uint32_t PARKED_READERS_SHIFT = 16;
+    static constexpr std::uint32_t PARKED_READER = 1u << PARKED_READERS_SHIFT;
+    static constexpr std::uint32_t PARKED_READERS = UPGRADER - PARKED_READER;
+    static constexpr std::uint32_t READERS = PARKED_READER - 1;
+
+    static bool reader_may_enter(std::uint32_t state)
+    {
+        if ((state & READERS) == READERS)
+            return false;
+        if (P == SharedLockPolicy::PreferReaders)
+            return !(state & WRITER);
+        return !(state & (WRITER | WRITERS_WAITING));
+    }
+
+    /// @brief State once the writer holding the mutex unlocks it.
+    static std::uint32_t unlocked_state(std::uint32_t state)
+    {
+        const std::uint32_t parked = state & PARKED_READERS;
+        if (P == SharedLockPolicy::PreferWriters || !parked)
+            return state & (PARKED_READERS | GENERATION);
+        // Let all parked readers in at once. Woken writers find them in, and hold new readers back again.
+        return ((state & GENERATION) ^ GENERATION) | (parked >> PARKED_READERS_SHIFT);
+    }
+
+    /// @brief Spin then park until the mutex is acquired or the deadline, if any, is reached.
+    template<typename Clock, typename Duration>
+    bool lock_slow(const std::chrono::time_point<Clock, Duration> *tp)
+    {
+        detail::Backoff backoff;
+        std::uint32_t state = m_state.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            if (!(state & (WRITER | READERS)))
+            {
+                if (m_state.compare_exchange_weak(state, state | WRITER, std::memory_order_acquire, std::memory_order_relaxed))
+                    return true;
+                continue;
+            }
+            if (backoff.is_spinning())
+            {
+                backoff.pause();
+                state = m_state.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (!(state & WRITERS_WAITING) && !m_state.compare_exchange_weak(state, state | WRITERS_WAITING, std::memory_order_relaxed))
+                continue;
+            if (!tp)
+            {
+                detail::futex_wait(m_state, state | WRITERS_WAITING);
+            }
+            else if (!detail::futex_wait_until(m_state, state | WRITERS_WAITING, *tp))
+            {
+                // Readers may be held back by this writer only, let every waiting thread reconsider.
+                if (m_state.fetch_and(~WRITERS_WAITING, std::memory_order_relaxed) & WRITERS_WAITING)
+                    detail::futex_wake_all(m_state);
+                return false;
+            }
+            state = m_state.load(std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief Spin then park until the mutex is acquired for upgrade. Parked upgraders wait as
+    /// writers do, holding new readers back unless readers are preferred.
+    void lock_upgrade_slow()
+    {
+        detail::Backoff backoff;
+        std::uint32_t state = m_state.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            if (reader_may_enter(state) && !(state & UPGRADER))
+            {
+                if (m_state.compare_exchange_weak(state, (state | UPGRADER) + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                    return;
+                continue;
+            }
+            if (backoff.is_spinning())
+            {
+                backoff.pause();
+                state = m_state.load(std::memory_order_relaxed);
+                continue;
+            }
+            // The count of readers is saturated, leaving readers do not wake parked threads up.
+            if ((state & READERS) == READERS)
+            {
+                std::this_thread::yield();
+                state = m_state.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (!(state & WRITERS_WAITING) && !m_state.compare_exchange_weak(state, state | WRITERS_WAITING, std::memory_order_relaxed))
+                continue;
+            detail::futex_wait(m_state, state | WRITERS_WAITING);
+            state = m_state.load(std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief Spin then park until the mutex is acquired or the deadline, if any, is reached.
+    template<typename Clock, typename Duration>
+    bool lock_shared_slow(const std::chrono::time_point<Clock, Duration> *tp)
+    {
+        detail::Backoff backoff;
+        std::uint32_t state = m_state.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            if (reader_may_enter(state))
+            {
+                if (m_state.compare_exchange_weak(state, state + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                    return true;
+                continue;
+            }
+            if (backoff.is_spinning())
+            {
+                backoff.pause();
+                state = m_state.load(std::memory_order_relaxed);
+                continue;
+            }
+            // The count of readers or of parked readers is saturated, yield instead of parking until
+            // some leave.
+            if ((state & READERS) == READERS || (state & PARKED_READERS) == PARKED_READERS)
+            {
+                if (tp && Clock::now() >= *tp)
+                    return false;
+                std::this_thread::yield();
+                state = m_state.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (m_state.compare_exchange_weak(state, state + PARKED_READER, std::memory_order_relaxed))
+                return park_reader(state + PARKED_READER, tp);
+        }
+    }
+
+    /// @brief Wait, registered as parked reader, until let in by a writer or allowed to come in.
+    /// @param state State after registration.
+    template<typename Clock, typename Duration>
+    bool park_reader(std::uint32_t state, const std::chrono::time_point<Clock, Duration> *tp)
+    {
+        const std::uint32_t generation = state & GENERATION;
+        for (;;)
+        {
+            bool timeout = false;
+            if (!tp)
+                detail::futex_wait(m_state, state);
+            else
+                timeout = !detail::futex_wait_until(m_state, state, *tp);
+            state = m_state.load(std::memory_order_acquire);
+            for (;;)
+            {
+                if ((state & GENERATION) != generation)
+                    return true;
+                if (!timeout && !reader_may_enter(state))
+                {
+                    if ((state & READERS) != READERS)
+                        break;
+                    // Leaving readers do not wake parked ones up, wait for them to leave here.
+                    std::this_thread::yield();
+                    state = m_state.load(std::memory_order_acquire);
+                    continue;
+                }
+                const std::uint32_t next = timeout ? state - PARKED_READER : state - PARKED_READER + 1;
+                if (m_state.compare_exchange_weak(state, next, std::memory_order_acquire, std::memory_order_acquire))
+                    return !timeout;
+            }
+        }
+    }
+
+    /// @brief Writer bit, waiting writers bit, generation bit, upgrader bit, number of parked readers
+    /// (12 bits, up to 4095, further readers yield instead of parking) and number of readers (16 bits).
+    std::atomic<std::uint32_t> m_state{0};
+};
+
+/// @brief Compact reader-writer mutex whose waiting writers hold new readers back, so that a steady
+/// flow of readers cannot starve them. This is the default mutex of Mustex since C++14.
+using SharedFutexMutex = BasicSharedFutexMutex<SharedLockPolicy::PreferWriters>;
 
 namespace detail
 {
 #ifdef _MUSTEX_HAS_SHARED_MUTEX
-using DefaultMustexMutex = std::shared_timed_mutex;
+using DefaultMustexMutex = SharedFutexMutex;
 #else // #ifdef _MUSTEX_HAS_SHARED_MUTEX
 using DefaultMustexMutex = std::timed_mutex;
 #endif // #ifdef _MUSTEX_HAS_SHARED_MUTEX
@@ -190,27 +904,286 @@ public:
         is_shared_lockable<T>::value;
 };
 
-/// @brief Methods to redirect read/write lock accesses to mutex,
-/// depending on whether or not the mutex is shared lockable.
-namespace proxy_mutex
+/// @brief Concept class whose member `value` indicates if a mutex is UpgradeLockable: it is
+/// SharedLockable, can be locked for upgrade by `lock_upgrade()`, `try_lock_upgrade()` and
+/// `unlock_upgrade()`, excluding other upgraders but not readers, and the upgrade lock can be
+/// atomically turned into an exclusive lock by `unlock_upgrade_and_lock()`.
+/// This named requirement is not standard, naming follows Boost.Thread.
+/// @tparam T Type of mutex to check.
+template<typename T>
+class is_upgrade_lockable
 {
-template<typename M>
-inline typename std::enable_if<is_basic_shared_lockable<M>::value, void>::type
-    lock_read(M &m)
+private:
+    template<typename U>
+    static auto test(int) -> decltype(std::declval<U>().lock_upgrade(), // must be valid
+                                      std::is_same<decltype(std::declval<U>().try_lock_upgrade()), bool>{}, // must return bool
+                                      std::declval<U>().unlock_upgrade(), // must be valid
+                                      std::declval<U>().unlock_upgrade_and_lock(), // must be valid
+                                      std::true_type{});
+
+    template<typename>
+    static std::false_type test(...);
+
+public:
+    static constexpr bool value = decltype(test<T>(0))::value && is_shared_lockable<T>::value;
+};
+
+/// @brief Concept class whose member `value` indicates if a mutex is Downgradable: it is
+/// BasicSharedLockable, and an exclusive lock can be atomically turned into a shared lock by
+/// `unlock_and_lock_shared()`.
+/// This named requirement is not standard, naming follows Boost.Thread.
+/// @tparam T Type of mutex to check.
+template<typename T>
+class is_downgradable
 {
-    m.lock_shared();
-}
-template<typename M>
-inline typename std::enable_if<!is_basic_shared_lockable<M>::value, void>::type
-    lock_read(M &m)
+private:
+    template<typename U>
+    static auto test(int) -> decltype(std::declval<U>().unlock_and_lock_shared(), // must be valid
+                                      std::true_type{});
+
+    template<typename>
+    static std::false_type test(...);
+
+public:
+    static constexpr bool value = decltype(test<T>(0))::value && is_basic_shared_lockable<T>::value;
+};
+
+/// @brief Concept class whose member `value` indicates if a lockable has a rank, given by its
+/// `rank` static member, see bcx::Ranked. Lockables locked together which all have a rank are
+/// locked in increasing rank order.
+/// @tparam T Type of lockable to check.
+template<typename T>
+class is_ranked
 {
-    m.lock();
-}
-template<typename M>
-inline void lock_write(M &m)
+private:
+    template<typename U>
+    static auto test(int) -> decltype(std::integral_constant<std::size_t, U::rank>{}, std::true_type{});
+
+    template<typename>
+    static std::false_type test(...);
+
+public:
+    static constexpr bool value = decltype(test<T>(0))::value;
+};
+
+/// @brief Rank of a ranked lockable.
+template<typename L>
+struct lock_rank : std::integral_constant<std::size_t, L::rank>
 {
-    m.lock();
-}
+};
+
+/// @brief Mutation posted to a Mustex, applied by a thread holding its mutex, see Mustex::post().
+struct PostedMutation
+{
+    PostedMutation *next = nullptr;
+    /// @brief Apply the mutation to given data, then destroy it. Only destroys it if data is null.
+    void (*apply)(PostedMutation &, void *) = nullptr;
+};
+
+/// @brief Mutation calling F on data of type T.
+template<typename T, typename F>
+struct PostedCall : PostedMutation
+{
+    explicit PostedCall(F f)
+        : function(std::move(f))
+    {
+        this->apply = [](PostedMutation &mutation, void *data)
+        {
+            std::unique_ptr<PostedCall> self(static_cast<PostedCall *>(&mutation));
+            if (data)
+                self->function(*static_cast<T *>(data));
+        };
+    }
+
+    F function;
+};
+
+/// @brief Concept class whose member `value` indicates if a mutex accepts posted mutations: they
+/// are queued up by `push_posted()` without blocking, and `take_posted()` returns them in posting
+/// order, linked by their `next` member. `is_held_by_this_thread()` tells whether calling thread
+/// holds the mutex for write access. See bcx::WithPosting.
+/// @tparam T Type of mutex to check.
+template<typename T>
+class is_posting
+{
+private:
+    template<typename U>
+    static auto test(int) -> decltype(std::declval<U>().push_posted(std::declval<PostedMutation *>()), // must be valid
+                                      std::is_same<decltype(std::declval<U>().take_posted()), PostedMutation *>{}, // must return mutations
+                                      std::is_same<decltype(std::declval<U>().has_posted()), bool>{}, // must return bool
+                                      std::is_same<decltype(std::declval<U>().is_held_by_this_thread()), bool>{}, // must return bool
+                                      std::true_type{});
+
+    template<typename>
+    static std::false_type test(...);
+
+public:
+    static constexpr bool value = decltype(test<T>(0))::value;
+};
+
+/// @brief Rank of a wrapped mutex, exposed by its wrapper if the wrapped mutex has one.
+template<class M, bool = is_ranked<M>::value>
+struct WrappedRank
+{
+};
+
+template<class M>
+struct WrappedRank<M, true>
+{
+    static constexpr std::size_t rank = M::rank;
+};
+
+/// @brief Base of mutex wrappers such as bcx::Ranked, forwarding every operation the wrapped mutex
+/// M supports to it, as well as its rank. Wrappers derive from it, and only override the operations
+/// they change, hiding the forwarding ones.
+template<class M>
+class MutexWrapper : public WrappedRank<M>
+{
+public:
+    MutexWrapper() = default;
+    MutexWrapper(const MutexWrapper &) = delete;
+    MutexWrapper &operator=(const MutexWrapper &) = delete;
+
+    void lock()
+    {
+        m_mutex.lock();
+    }
+
+    template<typename U = M>
+    auto try_lock() -> decltype(std::declval<U &>().try_lock())
+    {
+        return m_mutex.try_lock();
+    }
+
+    template<typename Rep, typename Period, typename U = M>
+    auto try_lock_for(const std::chrono::duration<Rep, Period> &d) -> decltype(std::declval<U &>().try_lock_for(d))
+    {
+        return m_mutex.try_lock_for(d);
+    }
+
+    template<typename Clock, typename Duration, typename U = M>
+    auto try_lock_until(const std::chrono::time_point<Clock, Duration> &tp)
+        -> decltype(std::declval<U &>().try_lock_until(tp))
+    {
+        return m_mutex.try_lock_until(tp);
+    }
+
+    void unlock()
+    {
+        m_mutex.unlock();
+    }
+
+    template<typename U = M>
+    auto lock_shared() -> decltype(std::declval<U &>().lock_shared())
+    {
+        m_mutex.lock_shared();
+    }
+
+    template<typename U = M>
+    auto try_lock_shared() -> decltype(std::declval<U &>().try_lock_shared())
+    {
+        return m_mutex.try_lock_shared();
+    }
+
+    template<typename Rep, typename Period, typename U = M>
+    auto try_lock_shared_for(const std::chrono::duration<Rep, Period> &d)
+        -> decltype(std::declval<U &>().try_lock_shared_for(d))
+    {
+        return m_mutex.try_lock_shared_for(d);
+    }
+
+    template<typename Clock, typename Duration, typename U = M>
+    auto try_lock_shared_until(const std::chrono::time_point<Clock, Duration> &tp)
+        -> decltype(std::declval<U &>().try_lock_shared_until(tp))
+    {
+        return m_mutex.try_lock_shared_until(tp);
+    }
+
+    template<typename U = M>
+    auto unlock_shared() -> decltype(std::declval<U &>().unlock_shared())
+    {
+        m_mutex.unlock_shared();
+    }
+
+    template<typename U = M>
+    auto lock_upgrade() -> decltype(std::declval<U &>().lock_upgrade())
+    {
+        m_mutex.lock_upgrade();
+    }
+
+    template<typename U = M>
+    auto try_lock_upgrade() -> decltype(std::declval<U &>().try_lock_upgrade())
+    {
+        return m_mutex.try_lock_upgrade();
+    }
+
+    template<typename U = M>
+    auto unlock_upgrade() -> decltype(std::declval<U &>().unlock_upgrade())
+    {
+        m_mutex.unlock_upgrade();
+    }
+
+    template<typename U = M>
+    auto unlock_upgrade_and_lock() -> decltype(std::declval<U &>().unlock_upgrade_and_lock())
+    {
+        m_mutex.unlock_upgrade_and_lock();
+    }
+
+    template<typename U = M>
+    auto unlock_and_lock_shared() -> decltype(std::declval<U &>().unlock_and_lock_shared())
+    {
+        m_mutex.unlock_and_lock_shared();
+    }
+
+    template<typename U = M>
+    auto push_posted(PostedMutation *mutation) -> decltype(std::declval<U &>().push_posted(mutation))
+    {
+        m_mutex.push_posted(mutation);
+    }
+
+    template<typename U = M>
+    auto take_posted() -> decltype(std::declval<U &>().take_posted())
+    {
+        return m_mutex.take_posted();
+    }
+
+    template<typename U = M>
+    auto has_posted() const -> decltype(std::declval<const U &>().has_posted())
+    {
+        return m_mutex.has_posted();
+    }
+
+    template<typename U = M>
+    auto is_held_by_this_thread() const -> decltype(std::declval<const U &>().is_held_by_this_thread())
+    {
+        return m_mutex.is_held_by_this_thread();
+    }
+
+protected:
+    M m_mutex;
+};
+
+/// @brief Methods to redirect read/write lock accesses to mutex,
+/// depending on whether or not the mutex is shared lockable.
+namespace proxy_mutex
+{
+template<typename M>
+inline typename std::enable_if<is_basic_shared_lockable<M>::value, void>::type
+    lock_read(M &m)
+{
+    m.lock_shared();
+}
+template<typename M>
+inline typename std::enable_if<!is_basic_shared_lockable<M>::value, void>::type
+    lock_read(M &m)
+{
+    m.lock();
+}
+template<typename M>
+inline void lock_write(M &m)
+{
+    m.lock();
+}
 
 template<typename M>
 inline typename std::enable_if<is_shared_lockable<M>::value, bool>::type
@@ -286,8 +1259,133 @@ inline void unlock_write(M &m)
 {
     m.unlock();
 }
+
+// Mutexes without readers are always locked exclusively, hence upgrading and downgrading is free.
+// Reader-writer mutexes must implement it.
+template<typename M>
+inline typename std::enable_if<is_upgrade_lockable<M>::value, void>::type
+    lock_upgrade(M &m)
+{
+    m.lock_upgrade();
+}
+template<typename M>
+inline typename std::enable_if<!is_basic_shared_lockable<M>::value, void>::type
+    lock_upgrade(M &m)
+{
+    m.lock();
+}
+
+template<typename M>
+inline typename std::enable_if<is_upgrade_lockable<M>::value, bool>::type
+    try_lock_upgrade(M &m)
+{
+    return m.try_lock_upgrade();
+}
+template<typename M>
+inline typename std::enable_if<!is_basic_shared_lockable<M>::value, bool>::type
+    try_lock_upgrade(M &m)
+{
+    return m.try_lock();
+}
+
+template<typename M>
+inline typename std::enable_if<is_upgrade_lockable<M>::value, void>::type
+    unlock_upgrade(M &m)
+{
+    m.unlock_upgrade();
+}
+template<typename M>
+inline typename std::enable_if<!is_basic_shared_lockable<M>::value, void>::type
+    unlock_upgrade(M &m)
+{
+    m.unlock();
+}
+
+template<typename M>
+inline typename std::enable_if<is_upgrade_lockable<M>::value, void>::type
+    upgrade(M &m)
+{
+    m.unlock_upgrade_and_lock();
+}
+template<typename M>
+inline typename std::enable_if<!is_basic_shared_lockable<M>::value, void>::type
+    upgrade(M &)
+{
+}
+
+template<typename M>
+inline typename std::enable_if<is_downgradable<M>::value, void>::type
+    downgrade(M &m)
+{
+    m.unlock_and_lock_shared();
+}
+template<typename M>
+inline typename std::enable_if<!is_basic_shared_lockable<M>::value, void>::type
+    downgrade(M &)
+{
+}
+
+// Mutexes which coroutines can wait for provide awaitables, readers falling back to exclusive
+// locking when the mutex has no `lock_shared_async()`.
+template<typename M, typename... Args>
+inline auto lock_read_async_impl(int, M &m, Args &&...args) -> decltype(m.lock_shared_async(std::forward<Args>(args)...))
+{
+    return m.lock_shared_async(std::forward<Args>(args)...);
+}
+template<typename M, typename... Args>
+inline auto lock_read_async_impl(long, M &m, Args &&...args) -> decltype(m.lock_async(std::forward<Args>(args)...))
+{
+    return m.lock_async(std::forward<Args>(args)...);
+}
+template<typename M, typename... Args>
+inline auto lock_read_async(M &m, Args &&...args) -> decltype(lock_read_async_impl(0, m, std::forward<Args>(args)...))
+{
+    return lock_read_async_impl(0, m, std::forward<Args>(args)...);
+}
+template<typename M, typename... Args>
+inline auto lock_write_async(M &m, Args &&...args) -> decltype(m.lock_async(std::forward<Args>(args)...))
+{
+    return m.lock_async(std::forward<Args>(args)...);
+}
 } // namespace proxy_mutex
 
+/// @brief Apply mutations posted to given mutex to given data, mutex must be held for writing.
+template<typename M, typename T>
+inline typename std::enable_if<is_posting<M>::value, void>::type apply_posted(M &m, T &data)
+{
+    PostedMutation *mutation = m.take_posted();
+    while (mutation)
+    {
+        PostedMutation *next = mutation->next;
+        mutation->apply(*mutation, std::addressof(data));
+        mutation = next;
+    }
+}
+template<typename M, typename T>
+inline typename std::enable_if<!is_posting<M>::value, void>::type apply_posted(M &, T &)
+{
+}
+
+/// @brief Apply mutations posted to given mutex to given data, as long as the mutex is available,
+/// once calling thread released it. Mutations are only posted to non-const Mustex, whose data is
+/// hence mutable.
+template<typename M, typename T>
+inline typename std::enable_if<is_posting<M>::value, void>::type apply_posted_if_free(M &m, const T &data)
+{
+    // Either the posting thread sees the mutex released, or its mutation is seen here.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (m.has_posted() && proxy_mutex::try_lock_write(m))
+    {
+        apply_posted(m, const_cast<T &>(data));
+        proxy_mutex::unlock_write(m);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+}
+template<typename M, typename T>
+inline typename std::enable_if<!is_posting<M>::value, void>::type apply_posted_if_free(M &, const T &)
+{
+}
+
 template<typename U>
 struct is_mustex : std::false_type
 {
@@ -298,6 +1396,69 @@ struct is_mustex<Mustex<T, M>> : std::true_type
 {
 };
 
+/// @brief Access to Mustex internals, for free standing locking methods.
+struct MustexAccess
+{
+    template<typename T, class M>
+    static M &mutex(const Mustex<T, M> &m)
+    {
+        return m.m_mutex;
+    }
+
+    /// @brief Create handle for read-only access on ALREADY ACQUIRED mutex.
+    template<typename T, class M>
+    static typename Mustex<T, M>::Handle adopt_read(const Mustex<T, M> &m)
+    {
+        return m.lock(std::adopt_lock);
+    }
+
+    /// @brief Create handle for write access on ALREADY ACQUIRED mutex.
+    template<typename T, class M>
+    static typename Mustex<T, M>::HandleMut adopt_write(Mustex<T, M> &m)
+    {
+        return m.lock_mut(std::adopt_lock);
+    }
+};
+
+/// @brief Create handle on ALREADY ACQUIRED mutex, for read-only access to a const Mustex.
+template<typename T, class M>
+typename Mustex<T, M>::Handle adopt_awaited(const Mustex<T, M> &m)
+{
+    return MustexAccess::adopt_read(m);
+}
+
+/// @brief Create handle on ALREADY ACQUIRED mutex, for write access to a non-const Mustex.
+template<typename T, class M>
+typename Mustex<T, M>::HandleMut adopt_awaited(Mustex<T, M> &m)
+{
+    return MustexAccess::adopt_write(m);
+}
+
+/// @brief Awaitable acquiring the mutex of a Mustex with the awaitable of the mutex, producing a
+/// handle once acquired, see Mustex::lock_async() and Mustex::lock_mut_async().
+/// @tparam A Type of the mutex awaitable.
+/// @tparam U Type of the Mustex, const for read-only access.
+template<typename A, typename U>
+struct MustexAwaiter
+{
+    A awaiter;
+    U *owner;
+
+    bool await_ready() { return awaiter.await_ready(); }
+
+    template<typename Coroutine>
+    auto await_suspend(Coroutine coroutine) -> decltype(awaiter.await_suspend(coroutine))
+    {
+        return awaiter.await_suspend(coroutine);
+    }
+
+    auto await_resume() -> decltype(adopt_awaited(*owner))
+    {
+        awaiter.await_resume();
+        return adopt_awaited(*owner);
+    }
+};
+
 /// @brief Extract mutex reference from raw mutex.
 template<typename U>
 auto get_mutex_ref(U &m) -> typename std::enable_if<!is_mustex<U>::value, U &>::type
@@ -309,111 +1470,515 @@ auto get_mutex_ref(U &m) -> typename std::enable_if<!is_mustex<U>::value, U &>::
 template<typename U>
 auto get_mutex_ref(U &m) -> typename std::enable_if<is_mustex<U>::value, typename U::mutex_t &>::type
 {
-    return m.m_mutex;
+    return MustexAccess::mutex(m);
+}
+
+/// @brief Acquire lock (adopt) for a raw mutex.
+template<template<class> class L, typename T>
+auto adopt_lock(T &m) -> typename std::enable_if<!is_mustex<T>::value, L<T>>::type
+{
+    return L<T>(m, std::adopt_lock);
+}
+
+/// @brief Acquire lock (adopt) for Mustex.
+template<template<class> class L, typename T>
+auto adopt_lock(T &m) -> typename std::enable_if<is_mustex<T>::value, typename T::HandleMut>::type
+{
+    return MustexAccess::adopt_write(m);
+}
+
+// C++11 does not provide std::index_sequence, implement it ourselves if necessary.
+#ifdef _MUSTEX_HAS_INT_SEQUENCE
+template<size_t... _Idx>
+using bcx_index_sequence = std::index_sequence<_Idx...>;
+template<size_t _Num>
+using bcx_make_index_sequence = std::make_index_sequence<_Num>;
+#else
+template<std::size_t... Indices>
+struct bcx_index_sequence
+{
+};
+
+template<std::size_t N, std::size_t... Indices>
+struct bcx_make_index_sequence_impl : bcx_make_index_sequence_impl<N - 1, N - 1, Indices...>
+{
+};
+
+template<std::size_t... Indices>
+struct bcx_make_index_sequence_impl<0, Indices...>
+{
+    typedef bcx_index_sequence<Indices...> type;
+};
+
+template<std::size_t N>
+using bcx_make_index_sequence = typename bcx_make_index_sequence_impl<N>::type;
+#endif
+
+/// @brief Request for read-only access to a Mustex, see bcx::read().
+template<typename U>
+struct ReadRequest
+{
+    const U &mustex;
+};
+
+/// @brief Request for write access to a Mustex, see bcx::write().
+template<typename U>
+struct WriteRequest
+{
+    U &mustex;
+};
+
+/// @brief Lockable view of a mutex locking it for read-only access, so that std::lock() can lock
+/// readers along with writers.
+template<typename M>
+class ReadLockable
+{
+public:
+    explicit ReadLockable(M &mutex)
+        : m_mutex(mutex)
+    {
+    }
+
+    void lock() { proxy_mutex::lock_read(m_mutex); }
+    bool try_lock() { return proxy_mutex::try_lock_read(m_mutex); }
+    void unlock() { proxy_mutex::unlock_read(m_mutex); }
+
+    M &mutex() const { return m_mutex; }
+
+private:
+    M &m_mutex;
+};
+
+/// @brief Address deciding when a lockable is acquired by lock_all_ordered().
+template<typename L>
+std::uintptr_t lock_order_key(L &lockable)
+{
+    return reinterpret_cast<std::uintptr_t>(std::addressof(lockable));
+}
+
+template<typename M>
+class is_ranked<ReadLockable<M>> : public is_ranked<M>
+{
+};
+
+template<typename M>
+struct lock_rank<ReadLockable<M>> : lock_rank<M>
+{
+};
+
+template<typename M>
+std::uintptr_t lock_order_key(ReadLockable<M> &lockable)
+{
+    return reinterpret_cast<std::uintptr_t>(std::addressof(lockable.mutex()));
+}
+
+/// @brief Type-erased lockable, to be sorted along with lockables of other types.
+struct OrderedLockable
+{
+    std::uintptr_t key;
+    void *lockable;
+    void (*lock)(void *);
+    void (*unlock)(void *);
+
+    bool operator<(const OrderedLockable &other) const { return key < other.key; }
+};
+
+template<typename L>
+OrderedLockable make_ordered_lockable(L &lockable)
+{
+    return OrderedLockable{
+        lock_order_key(lockable),
+        std::addressof(lockable),
+        [](void *l) { static_cast<L *>(l)->lock(); },
+        [](void *l) { static_cast<L *>(l)->unlock(); },
+    };
+}
+
+/// @brief Lock sorted lockables one after another, unlocking those already locked on exception.
+template<std::size_t N>
+void lock_in_order(std::array<OrderedLockable, N> &ordered)
+{
+    std::size_t locked = 0;
+    try
+    {
+        for (; locked < N; ++locked)
+            ordered[locked].lock(ordered[locked].lockable);
+    }
+    catch (...)
+    {
+        while (locked--)
+            ordered[locked].unlock(ordered[locked].lockable);
+        throw;
+    }
+}
+
+/// @brief Whether all given lockables, possibly references, have a rank.
+template<typename... L>
+struct are_ranked : std::true_type
+{
+};
+
+template<typename L, typename... Rest>
+struct are_ranked<L, Rest...>
+    : std::integral_constant<bool, is_ranked<typename std::decay<L>::type>::value && are_ranked<Rest...>::value>
+{
+};
+
+constexpr bool rank_absent(std::size_t)
+{
+    return true;
+}
+
+template<typename... Ranks>
+constexpr bool rank_absent(std::size_t rank, std::size_t first, Ranks... rest)
+{
+    return rank != first && rank_absent(rank, rest...);
+}
+
+constexpr bool ranks_distinct()
+{
+    return true;
+}
+
+template<typename... Ranks>
+constexpr bool ranks_distinct(std::size_t first, Ranks... rest)
+{
+    return rank_absent(first, rest...) && ranks_distinct(rest...);
+}
+
+/// @brief Number of given ranks lower than `rank`, that is position of `rank` once ranks are sorted.
+constexpr std::size_t ranks_below(std::size_t)
+{
+    return 0;
+}
+
+template<typename... Ranks>
+constexpr std::size_t ranks_below(std::size_t rank, std::size_t first, Ranks... rest)
+{
+    return (first < rank ? 1 : 0) + ranks_below(rank, rest...);
+}
+
+/// @brief Lock all given lockables one after another, in increasing order of their ranks. Each
+/// lockable is stored at its position in the locking order computed at compile time, nothing is
+/// sorted at runtime.
+template<std::size_t... Ranks, typename Tuple, std::size_t... I>
+void lock_all_ranked(Tuple &lockables, bcx_index_sequence<I...>)
+{
+    static_assert(ranks_distinct(Ranks...), "Ranked mutexes locked together must have distinct ranks");
+    std::array<OrderedLockable, sizeof...(I)> ordered;
+    const int placed[] = {(ordered[ranks_below(Ranks, Ranks...)] = make_ordered_lockable(std::get<I>(lockables)), 0)...};
+    (void)placed;
+    lock_in_order(ordered);
+}
+
+template<typename Tuple, std::size_t... I>
+void lock_all_impl(Tuple &mutexes, bcx_index_sequence<I...> indices, std::true_type /* ranked */)
+{
+    lock_all_ranked<lock_rank<typename std::decay<typename std::tuple_element<I, Tuple>::type>::type>::value...>(
+        mutexes,
+        indices
+    );
+}
+
+template<typename Tuple, std::size_t... I>
+void lock_all_impl(Tuple &mutexes, bcx_index_sequence<I...>, std::false_type /* ranked */)
+{
+    std::lock(std::get<I>(mutexes)...);
+}
+
+template<typename Tuple, std::size_t... I>
+void lock_all_impl(Tuple &mutexes, bcx_index_sequence<I...> indices)
+{
+    lock_all_impl(mutexes, indices, are_ranked<typename std::tuple_element<I, Tuple>::type...>{});
+}
+
+/// @brief Lock all given lockables, in increasing rank order if they all have a rank, otherwise
+/// with std::lock() deadlock avoidance.
+template<typename Tuple>
+void lock_all(Tuple &mutexes)
+{
+    constexpr std::size_t N = std::tuple_size<Tuple>::value;
+    lock_all_impl(mutexes, bcx_make_index_sequence<N>{});
+}
+
+template<typename Tuple, std::size_t... I>
+bool try_lock_all_impl(Tuple &mutexes, bcx_index_sequence<I...>)
+{
+    // Yes -1 is the success code. https://en.cppreference.com/w/cpp/thread/try_lock
+    return std::try_lock(std::get<I>(mutexes)...) == -1;
+}
+
+/// @brief Try to lock all given mutexes.
+/// @return True for success.
+template<typename Tuple>
+bool try_lock_all(Tuple &mutexes)
+{
+    constexpr std::size_t N = std::tuple_size<Tuple>::value;
+    return try_lock_all_impl(mutexes, bcx_make_index_sequence<N>{});
+}
+
+template<template<class> class L, typename... Args>
+auto lock_mut_impl(Args &...args) -> std::tuple<decltype(detail::adopt_lock<L>(args))...>
+{
+    auto mutex_refs = std::tie(detail::get_mutex_ref(args)...);
+    detail::lock_all(mutex_refs);
+    return std::make_tuple(detail::adopt_lock<L>(args)...);
+}
+
+template<template<class> class L, typename... Args>
+auto try_lock_mut_impl(Args &...args)
+    -> Optional<std::tuple<decltype(detail::adopt_lock<L>(args))...>>
+{
+    auto mutex_refs = std::tie(detail::get_mutex_ref(args)...);
+    if (!detail::try_lock_all(mutex_refs))
+        return {};
+    return std::make_tuple(detail::adopt_lock<L>(args)...);
+}
+
+/// @brief Whether all given lockables, possibly references, are TimedLockable.
+template<typename... L>
+struct are_timed_lockable : std::true_type
+{
+};
+
+template<typename L, typename... Rest>
+struct are_timed_lockable<L, Rest...>
+    : std::integral_constant<bool, is_timed_lockable<typename std::decay<L>::type>::value && are_timed_lockable<Rest...>::value>
+{
+};
+
+/// @brief Type-erased TimedLockable, waiting until a deadline of a given clock and duration.
+struct TimedLockable
+{
+    void *lockable;
+    bool (*try_lock)(void *);
+    bool (*try_lock_until)(void *, const void *);
+    void (*unlock)(void *);
+};
+
+template<typename Clock, typename Duration, typename L>
+TimedLockable make_timed_lockable(L &lockable)
+{
+    return TimedLockable{
+        std::addressof(lockable),
+        [](void *l) { return static_cast<L *>(l)->try_lock(); },
+        [](void *l, const void *tp)
+        { return static_cast<L *>(l)->try_lock_until(*static_cast<const std::chrono::time_point<Clock, Duration> *>(tp)); },
+        [](void *l) { static_cast<L *>(l)->unlock(); },
+    };
+}
+
+/// @brief Try to lock all given lockables until deadline, with the algorithm of std::lock(): wait
+/// for one lockable, here until the deadline, try the others, and if one is busy release all of
+/// them to wait for the busy one. Contended threads hence wait within the mutexes, instead of
+/// spinning on std::try_lock().
+/// @return True for success, false if the deadline was reached first, nothing being locked then.
+template<typename Tuple, typename Clock, typename Duration, std::size_t... I>
+bool try_lock_all_until_impl(Tuple &lockables, const std::chrono::time_point<Clock, Duration> &tp, bcx_index_sequence<I...>)
+{
+    constexpr std::size_t N = sizeof...(I);
+    std::array<TimedLockable, N> all{{make_timed_lockable<Clock, Duration>(std::get<I>(lockables))...}};
+    std::size_t first = 0;
+    for (;;)
+    {
+        if (!all[first].try_lock_until(all[first].lockable, &tp))
+            return false;
+        std::size_t locked = 1;
+        for (; locked < N; ++locked)
+        {
+            TimedLockable &next = all[(first + locked) % N];
+            if (!next.try_lock(next.lockable))
+                break;
+        }
+        if (locked == N)
+            return true;
+        const std::size_t busy = (first + locked) % N;
+        while (locked--)
+        {
+            TimedLockable &acquired = all[(first + locked) % N];
+            acquired.unlock(acquired.lockable);
+        }
+        first = busy;
+    }
+}
+
+/// @brief Try to lock all given mutexes until deadline.
+/// @return True for success.
+template<typename Tuple, typename Clock, typename Duration>
+bool try_lock_all_until(Tuple &mutexes, const std::chrono::time_point<Clock, Duration> &tp)
+{
+    constexpr std::size_t N = std::tuple_size<Tuple>::value;
+    return try_lock_all_until_impl(mutexes, tp, bcx_make_index_sequence<N>{});
+}
+
+template<template<class> class L, typename Clock, typename Duration, typename... Args>
+auto try_lock_mut_until_impl(const std::chrono::time_point<Clock, Duration> &tp, Args &...args)
+    -> Optional<std::tuple<decltype(detail::adopt_lock<L>(args))...>>
+{
+    static_assert(
+        are_timed_lockable<decltype(detail::get_mutex_ref(args))...>::value,
+        "Timed multi-lock requires TimedLockable mutexes"
+    );
+    auto mutex_refs = std::tie(detail::get_mutex_ref(args)...);
+    if (!detail::try_lock_all_until(mutex_refs, tp))
+        return {};
+    return std::make_tuple(detail::adopt_lock<L>(args)...);
+}
+
+template<typename Tuple, std::size_t... I>
+void lock_all_ordered_impl(Tuple &lockables, bcx_index_sequence<I...> indices, std::true_type /* ranked */)
+{
+    lock_all_ranked<lock_rank<typename std::decay<typename std::tuple_element<I, Tuple>::type>::type>::value...>(
+        lockables,
+        indices
+    );
+}
+
+template<typename Tuple, std::size_t... I>
+void lock_all_ordered_impl(Tuple &lockables, bcx_index_sequence<I...>, std::false_type /* ranked */)
+{
+    std::array<OrderedLockable, sizeof...(I)> ordered{{make_ordered_lockable(std::get<I>(lockables))...}};
+    std::sort(ordered.begin(), ordered.end());
+    lock_in_order(ordered);
+}
+
+template<typename Tuple, std::size_t... I>
+void lock_all_ordered_impl(Tuple &lockables, bcx_index_sequence<I...> indices)
+{
+    lock_all_ordered_impl(lockables, indices, are_ranked<typename std::tuple_element<I, Tuple>::type...>{});
+}
+
+/// @brief Lock all given lockables one after another, in increasing rank order if they all have a
+/// rank, otherwise in order of the mutexes addresses.
+template<typename Tuple>
+void lock_all_ordered(Tuple &lockables)
+{
+    constexpr std::size_t N = std::tuple_size<Tuple>::value;
+    lock_all_ordered_impl(lockables, bcx_make_index_sequence<N>{});
 }
 
-/// @brief Acquire lock (adopt) for a raw mutex.
-template<template<class> class L, typename T>
-auto adopt_lock(T &m) -> typename std::enable_if<!is_mustex<T>::value, L<T>>::type
+template<template<class> class L, typename... Args>
+auto lock_mut_ordered_impl(Args &...args) -> std::tuple<decltype(detail::adopt_lock<L>(args))...>
 {
-    return L<T>(m, std::adopt_lock);
+    auto mutex_refs = std::tie(detail::get_mutex_ref(args)...);
+    detail::lock_all_ordered(mutex_refs);
+    return std::make_tuple(detail::adopt_lock<L>(args)...);
 }
 
-/// @brief Acquire lock (adopt) for Mustex.
-template<template<class> class L, typename T>
-auto adopt_lock(T &m) -> typename std::enable_if<is_mustex<T>::value, typename T::HandleMut>::type
+template<typename U>
+ReadLockable<typename U::mutex_t> get_lockable(const ReadRequest<U> &request)
 {
-    return m.lock_mut(std::adopt_lock);
+    return ReadLockable<typename U::mutex_t>(MustexAccess::mutex(request.mustex));
 }
 
-// C++11 does not provide std::index_sequence, implement it ourselves if necessary.
-#ifdef _MUSTEX_HAS_INT_SEQUENCE
-template<size_t... _Idx>
-using bcx_index_sequence = std::index_sequence<_Idx...>;
-template<size_t _Num>
-using bcx_make_index_sequence = std::make_index_sequence<_Num>;
-#else
-template<std::size_t... Indices>
-struct bcx_index_sequence
+template<typename U>
+typename U::mutex_t &get_lockable(const WriteRequest<U> &request)
 {
-};
+    return MustexAccess::mutex(request.mustex);
+}
 
-template<std::size_t N, std::size_t... Indices>
-struct bcx_make_index_sequence_impl : bcx_make_index_sequence_impl<N - 1, N - 1, Indices...>
+template<typename U>
+typename U::Handle adopt_request(const ReadRequest<U> &request)
 {
-};
+    return MustexAccess::adopt_read(request.mustex);
+}
 
-template<std::size_t... Indices>
-struct bcx_make_index_sequence_impl<0, Indices...>
+template<typename U>
+typename U::HandleMut adopt_request(const WriteRequest<U> &request)
 {
-    typedef bcx_index_sequence<Indices...> type;
-};
-
-template<std::size_t N>
-using bcx_make_index_sequence = typename bcx_make_index_sequence_impl<N>::type;
-#endif
+    return MustexAccess::adopt_write(request.mustex);
+}
 
-template<typename Tuple, std::size_t... I>
-void lock_all_impl(Tuple &mutexes, bcx_index_sequence<I...>)
+template<typename... Requests>
+auto lock_impl(const Requests &...requests) -> std::tuple<decltype(detail::adopt_request(requests))...>
 {
-    std::lock(std::get<I>(mutexes)...);
+    std::tuple<decltype(detail::get_lockable(requests))...> lockables(detail::get_lockable(requests)...);
+    detail::lock_all(lockables);
+    return std::make_tuple(detail::adopt_request(requests)...);
 }
 
-template<typename Tuple>
-void lock_all(Tuple &mutexes)
+template<typename... Requests>
+auto lock_ordered_impl(const Requests &...requests) -> std::tuple<decltype(detail::adopt_request(requests))...>
 {
-    constexpr std::size_t N = std::tuple_size<Tuple>::value;
-    lock_all_impl(mutexes, bcx_make_index_sequence<N>{});
+    std::tuple<decltype(detail::get_lockable(requests))...> lockables(detail::get_lockable(requests)...);
+    detail::lock_all_ordered(lockables);
+    return std::make_tuple(detail::adopt_request(requests)...);
 }
 
-template<typename Tuple, std::size_t... I>
-bool try_lock_all_impl(Tuple &mutexes, bcx_index_sequence<I...>)
+template<typename... Requests>
+auto try_lock_impl(const Requests &...requests) -> Optional<std::tuple<decltype(detail::adopt_request(requests))...>>
 {
-    // Yes -1 is the success code. https://en.cppreference.com/w/cpp/thread/try_lock
-    return std::try_lock(std::get<I>(mutexes)...) == -1;
+    std::tuple<decltype(detail::get_lockable(requests))...> lockables(detail::get_lockable(requests)...);
+    if (!detail::try_lock_all(lockables))
+        return {};
+    return std::make_tuple(detail::adopt_request(requests)...);
 }
 
-/// @brief Try to lock all given mutexes.
-/// @return True for success.
-template<typename Tuple>
-bool try_lock_all(Tuple &mutexes)
+/// @brief Number of handles bcx::lock_mut_range() stores without allocating.
+constexpr std::size_t RANGE_INLINE_HANDLES = 8;
+
+/// @brief Mustex of a range, whose elements are either Mustex or pointers to Mustex.
+template<typename U>
+auto range_mustex(U &mustex) -> typename std::enable_if<is_mustex<U>::value, U &>::type
 {
-    constexpr std::size_t N = std::tuple_size<Tuple>::value;
-    return try_lock_all_impl(mutexes, bcx_make_index_sequence<N>{});
+    return mustex;
 }
 
-template<template<class> class L, typename... Args>
-auto lock_mut_impl(Args &...args) -> std::tuple<decltype(detail::adopt_lock<L>(args))...>
+template<typename U>
+auto range_mustex(U *mustex) -> typename std::enable_if<is_mustex<U>::value, U &>::type
 {
-    auto mutex_refs = std::tie(detail::get_mutex_ref(args)...);
-    detail::lock_all(mutex_refs);
-    return std::make_tuple(detail::adopt_lock<L>(args)...);
+    return *mustex;
 }
 
-template<template<class> class L, typename... Args>
-auto try_lock_mut_impl(Args &...args)
-#ifdef _MUSTEX_HAS_OPTIONAL
-    -> std::optional<std::tuple<decltype(detail::adopt_lock<L>(args))...>>
-#else
-    -> std::unique_ptr<std::tuple<decltype(detail::adopt_lock<L>(args))...>>
-#endif
+template<typename It>
+using range_mustex_t = typename std::remove_reference<decltype(range_mustex(*std::declval<It &>()))>::type;
+
+template<typename It>
+using RangeHandles = SmallVector<typename range_mustex_t<It>::HandleMut, RANGE_INLINE_HANDLES>;
+
+/// @brief Lock mutably all Mustex of given range one after another, in order of the mutexes
+/// addresses as bcx::ordered_lock does, unlocking those already locked on failure or exception.
+/// @param acquire Callable acquiring given mutex, returning false on failure.
+/// @return Handles in range order if all Mustex were acquired, empty optional otherwise.
+template<typename It, typename Acquire>
+Optional<RangeHandles<It>> lock_mut_range_impl(It first, It last, Acquire acquire)
 {
-    auto mutex_refs = std::tie(detail::get_mutex_ref(args)...);
-    if (!detail::try_lock_all(mutex_refs))
+    using mutex_t = typename range_mustex_t<It>::mutex_t;
+    SmallVector<mutex_t *, RANGE_INLINE_HANDLES> ordered;
+    for (It it = first; it != last; ++it)
+        ordered.push_back(std::addressof(MustexAccess::mutex(range_mustex(*it))));
+    std::sort(ordered.begin(), ordered.end(), std::less<mutex_t *>());
+    // Reserved before acquiring, so that adopting the mutexes once all are held cannot throw.
+    RangeHandles<It> handles;
+    handles.reserve(ordered.size());
+    std::size_t locked = 0;
+    try
+    {
+        for (; locked < ordered.size(); ++locked)
+            if (!acquire(*ordered[locked]))
+                break;
+    }
+    catch (...)
+    {
+        while (locked--)
+            proxy_mutex::unlock_write(*ordered[locked]);
+        throw;
+    }
+    if (locked < ordered.size())
+    {
+        while (locked--)
+            proxy_mutex::unlock_write(*ordered[locked]);
         return {};
-    auto tuple = std::make_tuple(detail::adopt_lock<L>(args)...);
-#ifdef _MUSTEX_HAS_OPTIONAL
-    return std::move(tuple);
-#else
-    return std::unique_ptr<std::tuple<decltype(detail::adopt_lock<L>(args))...>>(
-        new std::tuple<decltype(detail::adopt_lock<L>(args))...>(std::move(tuple))
-    );
-#endif
+    }
+    for (; first != last; ++first)
+        handles.push_back(MustexAccess::adopt_write(range_mustex(*first)));
+    return handles;
 }
 
 } // namespace detail
 
-/// @brief Lock mutably any given Mustex or raw mutex using deadlock avoidance.
+/// @brief Lock mutably any given Mustex or raw mutex using deadlock avoidance, or in increasing
+/// rank order if all of them are ranked, see bcx::Ranked.
 /// @tparam L Type of lock to use on raw mutexes.
 /// @tparam ...Args Types of given arguments.
 /// @param ...args Arbitrary number of Mustex and/or raw mutex.
@@ -424,6 +1989,18 @@ inline auto lock_mut(Args &...args) -> decltype(detail::lock_mut_impl<L>(args...
     return detail::lock_mut_impl<L>(args...);
 }
 
+/// @brief Lock mutably any given Mustex or raw mutex in order of the mutexes addresses, or in
+/// increasing rank order if all of them are ranked, see bcx::ordered_lock.
+/// @tparam L Type of lock to use on raw mutexes.
+/// @tparam ...Args Types of given arguments.
+/// @param ...args Arbitrary number of Mustex and/or raw mutex.
+/// @return Tuple containing a Mustex::HandleMut for each given Mustex, and a lock for each raw mutex.
+template<template<class> class L = std::unique_lock, typename... Args>
+inline auto lock_mut(ordered_lock_t, Args &...args) -> decltype(detail::lock_mut_ordered_impl<L>(args...))
+{
+    return detail::lock_mut_ordered_impl<L>(args...);
+}
+
 /// @brief Tries to lock mutably any given Mustex or raw mutex using deadlock avoidance.
 /// @tparam L Type of lock to use on raw mutexes.
 /// @tparam ...Args Types of given arguments.
@@ -436,28 +2013,205 @@ inline auto try_lock_mut(Args &...args) -> decltype(detail::try_lock_mut_impl<L>
     return detail::try_lock_mut_impl<L>(args...);
 }
 
+/// @brief Tries to lock mutably any given Mustex or raw mutex using deadlock avoidance, for given
+/// amount of time. Threads wait within the busy mutex rather than retrying right away.
+/// @tparam L Type of lock to use on raw mutexes.
+/// @tparam ...Args Types of given arguments.
+/// @param d Amount of time to try acquiring all arguments. Returns if exceeded.
+/// @param ...args Arbitrary number of Mustex and/or raw mutex, all TimedLockable.
+/// @return Optional tuple. Contains nothing if the arguments could not be all locked in time.
+///         Otherwise contains a Mustex::HandleMut for each given Mustex, and a lock for each raw mutex.
+template<template<class> class L = std::unique_lock, typename Rep, typename Period, typename... Args>
+inline auto try_lock_mut_for(const std::chrono::duration<Rep, Period> &d, Args &...args)
+    -> decltype(detail::try_lock_mut_until_impl<L>(std::chrono::steady_clock::now() + d, args...))
+{
+    return detail::try_lock_mut_until_impl<L>(std::chrono::steady_clock::now() + d, args...);
+}
+
+/// @brief Tries to lock mutably any given Mustex or raw mutex using deadlock avoidance, until given
+/// instant is reached. Threads wait within the busy mutex rather than retrying right away.
+/// @tparam L Type of lock to use on raw mutexes.
+/// @tparam ...Args Types of given arguments.
+/// @param tp Deadline for all arguments to be acquired. Returns if reached.
+/// @param ...args Arbitrary number of Mustex and/or raw mutex, all TimedLockable.
+/// @return Optional tuple. Contains nothing if the arguments could not be all locked in time.
+///         Otherwise contains a Mustex::HandleMut for each given Mustex, and a lock for each raw mutex.
+template<template<class> class L = std::unique_lock, typename Clock, typename Duration, typename... Args>
+inline auto try_lock_mut_until(const std::chrono::time_point<Clock, Duration> &tp, Args &...args)
+    -> decltype(detail::try_lock_mut_until_impl<L>(tp, args...))
+{
+    return detail::try_lock_mut_until_impl<L>(tp, args...);
+}
+
+/// @brief Request read-only access to given Mustex, from bcx::lock() or bcx::try_lock().
+template<typename U>
+inline auto read(const U &m) -> typename std::enable_if<detail::is_mustex<U>::value, detail::ReadRequest<U>>::type
+{
+    return detail::ReadRequest<U>{m};
+}
+
+/// @brief Request write access to given Mustex, from bcx::lock() or bcx::try_lock().
+template<typename U>
+inline auto write(U &m) -> typename std::enable_if<detail::is_mustex<U>::value, detail::WriteRequest<U>>::type
+{
+    return detail::WriteRequest<U>{m};
+}
+
+/// @brief Lock any given Mustex, each for read-only or write access, using deadlock avoidance, or
+/// in increasing rank order if all of them are ranked, see bcx::Ranked. Each Mustex must be given
+/// once at most.
+/// @tparam ...Requests Types of given requests.
+/// @param ...requests Arbitrary number of bcx::read(mustex) and bcx::write(mustex).
+/// @return Tuple containing a Mustex::Handle for each read request, and a Mustex::HandleMut for each
+///         write request.
+template<typename... Requests>
+inline auto lock(const Requests &...requests) -> decltype(detail::lock_impl(requests...))
+{
+    return detail::lock_impl(requests...);
+}
+
+/// @brief Lock any given Mustex, each for read-only or write access, in order of the mutexes
+/// addresses, or in increasing rank order if all of them are ranked, see bcx::ordered_lock. Each
+/// Mustex must be given once at most.
+/// @tparam ...Requests Types of given requests.
+/// @param ...requests Arbitrary number of bcx::read(mustex) and bcx::write(mustex).
+/// @return Tuple containing a Mustex::Handle for each read request, and a Mustex::HandleMut for each
+///         write request.
+template<typename... Requests>
+inline auto lock(ordered_lock_t, const Requests &...requests) -> decltype(detail::lock_ordered_impl(requests...))
+{
+    return detail::lock_ordered_impl(requests...);
+}
+
+/// @brief Tries to lock any given Mustex, each for read-only or write access, using deadlock
+/// avoidance. Each Mustex must be given once at most.
+/// @tparam ...Requests Types of given requests.
+/// @param ...requests Arbitrary number of bcx::read(mustex) and bcx::write(mustex).
+/// @return Optional tuple. Contains nothing if at least one Mustex could not be locked.
+///         Otherwise contains a Mustex::Handle for each read request, and a Mustex::HandleMut for
+///         each write request.
+template<typename... Requests>
+inline auto try_lock(const Requests &...requests) -> decltype(detail::try_lock_impl(requests...))
+{
+    return detail::try_lock_impl(requests...);
+}
+
+/// @brief Lock mutably every Mustex of given range, whose size is only known at runtime. Mustex
+/// are locked one after another in order of their mutexes addresses, as with bcx::ordered_lock.
+/// Each Mustex must be given once at most. Mustex of a range all share the same rank if ranked,
+/// hence blocking on several of them is refused at compile time, see bcx::Ranked.
+/// @tparam It Forward iterator on Mustex, or on pointers to Mustex, all of the same type.
+/// @param first, last Range of Mustex to lock.
+/// @return Vector of Mustex::HandleMut in range order, not allocating for small ranges.
+template<typename It>
+inline detail::RangeHandles<It> lock_mut_range(It first, It last)
+{
+    using mutex_t = typename detail::range_mustex_t<It>::mutex_t;
+    static_assert(
+        !detail::is_ranked<mutex_t>::value,
+        "Ranked mutexes of a range share the same rank, hence cannot be locked together by blocking"
+    );
+    return std::move(*detail::lock_mut_range_impl(
+        first,
+        last,
+        [](mutex_t &m)
+        {
+            detail::proxy_mutex::lock_write(m);
+            return true;
+        }
+    ));
+}
+
+/// @brief Tries to lock mutably every Mustex of given range, see bcx::lock_mut_range().
+/// @return Optional vector. Contains nothing if at least one Mustex could not be locked.
+///         Otherwise contains a Mustex::HandleMut for each Mustex, in range order.
+template<typename It>
+inline detail::Optional<detail::RangeHandles<It>> try_lock_mut_range(It first, It last)
+{
+    using mutex_t = typename detail::range_mustex_t<It>::mutex_t;
+    return detail::lock_mut_range_impl(first, last, [](mutex_t &m) { return detail::proxy_mutex::try_lock_write(m); });
+}
+
+/// @brief Tries to lock mutably every Mustex of given range until given instant is reached, see
+/// bcx::lock_mut_range(). Mutexes must be TimedLockable.
+/// @param tp Deadline for all Mustex to be acquired. Returns if reached.
+/// @return Optional vector. Contains nothing if the Mustex could not be all locked in time.
+///         Otherwise contains a Mustex::HandleMut for each Mustex, in range order.
+template<typename It, typename Clock, typename Duration>
+inline detail::Optional<detail::RangeHandles<It>> try_lock_mut_range_until(
+    It first,
+    It last,
+    const std::chrono::time_point<Clock, Duration> &tp
+)
+{
+    using mutex_t = typename detail::range_mustex_t<It>::mutex_t;
+    return detail::lock_mut_range_impl(first, last, [&tp](mutex_t &m) { return detail::proxy_mutex::try_lock_write_until(m, tp); });
+}
+
+/// @brief Tries to lock mutably every Mustex of given range for given amount of time, see
+/// bcx::lock_mut_range(). Mutexes must be TimedLockable.
+/// @param d Amount of time to try acquiring all Mustex. Returns if exceeded.
+/// @return Optional vector. Contains nothing if the Mustex could not be all locked in time.
+///         Otherwise contains a Mustex::HandleMut for each Mustex, in range order.
+template<typename It, typename Rep, typename Period>
+inline detail::Optional<detail::RangeHandles<It>> try_lock_mut_range_for(
+    It first,
+    It last,
+    const std::chrono::duration<Rep, Period> &d
+)
+{
+    return try_lock_mut_range_until(first, last, std::chrono::steady_clock::now() + d);
+}
+
 /// @brief Allow to access Mustex data, mutably or not depending on method used to construct.
 /// This class is scope-based, and will release access access ownership as soon as dropped.
 /// @tparam T Type of data to be accessed, potentially const-qualified.
 /// @tparam M Type of mutex owned by this class.
-template<typename T, class M>
+/// @tparam O Type of Mustex accessed, differing from `Mustex<data_t, M>` for Mustex of const data.
+template<typename T, class M, class O>
 class MustexHandle
 {
 private:
+    /// @brief Type of Mustex accessed, const-qualified for read-only access.
+    using owner_t = typename std::conditional<std::is_const<T>::value, const O, O>::type;
+
     void unlock()
     {
-        if (!m_mutex)
-            return;
-        if (std::is_const<T>::value)
-            detail::proxy_mutex::unlock_read(*m_mutex);
-        else
-            detail::proxy_mutex::unlock_write(*m_mutex);
+        if (m_owner)
+            unlock(std::is_const<T>{});
+    }
+
+    void unlock(std::true_type)
+    {
+        detail::proxy_mutex::unlock_read(m_owner->m_mutex);
+        detail::apply_posted_if_free(m_owner->m_mutex, m_owner->m_data);
+    }
+
+    void unlock(std::false_type)
+    {
+        detail::apply_posted(m_owner->m_mutex, m_owner->m_data);
+        detail::proxy_mutex::unlock_write(m_owner->m_mutex);
+        detail::apply_posted_if_free(m_owner->m_mutex, m_owner->m_data);
+    }
+
+    void acquired(std::true_type)
+    {
+    }
+
+    void acquired(std::false_type)
+    {
+        detail::apply_posted(m_owner->m_mutex, m_owner->m_data);
     }
 
 public:
     // Only parent Mustex can instantiate this class.
     template<class MT, class MM>
     friend class Mustex;
+    // As well as other handles, when changing access.
+    template<typename, class, class>
+    friend class MustexHandle;
+    template<typename, class>
+    friend class MustexUpgradableHandle;
 
     /// @brief The type of contained value, exposed for convenience.
     using data_t = typename std::remove_cv<T>::type;
@@ -465,49 +2219,142 @@ public:
     MustexHandle() = delete;
     MustexHandle(const MustexHandle &) = delete;
     MustexHandle(MustexHandle &&other)
-        : m_mutex{other.m_mutex}
-        , m_data{other.m_data}
+        : m_owner{other.m_owner}
     {
-        other.m_mutex = nullptr;
-        other.m_data = nullptr;
+        other.m_owner = nullptr;
     }
 
     MustexHandle &operator=(const MustexHandle &other) = delete;
     MustexHandle &operator=(MustexHandle &&other)
     {
         unlock();
-        m_data = other.m_data;
-        other.m_data = nullptr;
-        m_mutex = other.m_mutex;
-        other.m_mutex = nullptr;
+        m_owner = other.m_owner;
+        other.m_owner = nullptr;
         return *this;
     }
 
-    virtual ~MustexHandle()
+    ~MustexHandle()
     {
+        static_assert(sizeof(MustexHandle) == sizeof(owner_t *), "MustexHandle must be a single pointer");
         unlock();
     }
 
     T &operator*()
     {
-        return *m_data;
+        return m_owner->m_data;
     }
 
     T *operator->()
     {
-        return m_data;
+        return std::addressof(m_owner->m_data);
+    }
+
+    /// @brief Atomically turn write access into read-only access, no writer being able to access
+    /// data in between. Other readers are let in. Only available with mutexes that are Downgradable,
+    /// or have no readers.
+    /// @return Handle on data for read-only access. This handle is left empty.
+    template<typename U = T>
+    auto downgrade() && -> typename std::enable_if<!std::is_const<U>::value, MustexHandle<const data_t, M, O>>::type
+    {
+        static_assert(
+            detail::is_downgradable<M>::value || !detail::is_basic_shared_lockable<M>::value,
+            "Reader-writer mutex must be Downgradable to downgrade"
+        );
+        detail::apply_posted(m_owner->m_mutex, m_owner->m_data);
+        detail::proxy_mutex::downgrade(m_owner->m_mutex);
+        owner_t *owner = m_owner;
+        m_owner = nullptr;
+        return MustexHandle<const data_t, M, O>(owner);
+    }
+
+private:
+    owner_t *m_owner;
+
+    /// @brief Create handle on ALREADY ACQUIRED mutex, applying posted mutations first for write
+    /// access.
+    /// @param owner Mustex whose mutex was acquired.
+    explicit MustexHandle(owner_t *owner)
+        : m_owner{owner}
+    {
+        acquired(std::is_const<T>{});
+    }
+};
+
+/// @brief Allow to access Mustex data read-only, alongside readers but excluding writers and other
+/// upgradable handles, with the option to atomically upgrade to write access.
+/// This class is scope-based, and will release access ownership as soon as dropped.
+/// @tparam T Type of data to be accessed.
+/// @tparam M Type of mutex owned by this class.
+template<typename T, class M>
+class MustexUpgradableHandle
+{
+private:
+    void unlock()
+    {
+        if (!m_owner)
+            return;
+        detail::proxy_mutex::unlock_upgrade(m_owner->m_mutex);
+        detail::apply_posted_if_free(m_owner->m_mutex, m_owner->m_data);
+    }
+
+public:
+    // Only parent Mustex can instantiate this class.
+    template<class MT, class MM>
+    friend class Mustex;
+
+    /// @brief The type of contained value, exposed for convenience.
+    using data_t = T;
+
+    MustexUpgradableHandle() = delete;
+    MustexUpgradableHandle(const MustexUpgradableHandle &) = delete;
+    MustexUpgradableHandle(MustexUpgradableHandle &&other)
+        : m_owner{other.m_owner}
+    {
+        other.m_owner = nullptr;
+    }
+
+    MustexUpgradableHandle &operator=(const MustexUpgradableHandle &other) = delete;
+    MustexUpgradableHandle &operator=(MustexUpgradableHandle &&other)
+    {
+        unlock();
+        m_owner = other.m_owner;
+        other.m_owner = nullptr;
+        return *this;
+    }
+
+    ~MustexUpgradableHandle()
+    {
+        unlock();
+    }
+
+    const T &operator*() const
+    {
+        return m_owner->m_data;
+    }
+
+    const T *operator->() const
+    {
+        return std::addressof(m_owner->m_data);
+    }
+
+    /// @brief Atomically turn read-only access into write access, waiting for other readers to
+    /// leave. No writer can access data in between, hence what was read is still up to date.
+    /// @return Handle on data for write access. This handle is left empty.
+    MustexHandle<T, M> upgrade() &&
+    {
+        detail::proxy_mutex::upgrade(m_owner->m_mutex);
+        Mustex<T, M> *owner = m_owner;
+        m_owner = nullptr;
+        return MustexHandle<T, M>(owner);
     }
 
 private:
-    M *m_mutex;
-    T *m_data;
+    Mustex<T, M> *m_owner;
 
-    /// @brief Create handle on ALREADY ACQUIRED mutex.
-    /// @param mutex
-    /// @param data
-    MustexHandle(M *mutex, T *data)
-        : m_mutex{mutex}
-        , m_data{data}
+    /// @brief Create handle on mutex ALREADY ACQUIRED for upgrade.
+    /// @param owner Mustex whose mutex was acquired.
+    explicit MustexUpgradableHandle(Mustex<T, M> *owner)
+        : m_owner{owner}
     {
     }
 };
@@ -525,9 +2372,11 @@ public:
     /// @brief The type of mutex used, exposed for convenience.
     using mutex_t = M;
     /// @brief The type of handle used to access data.
-    using Handle = MustexHandle<const data_t, M>;
+    using Handle = MustexHandle<const data_t, M, Mustex>;
     /// @brief The type of handle used to access data mutably.
-    using HandleMut = MustexHandle<data_t, M>;
+    using HandleMut = MustexHandle<data_t, M, Mustex>;
+    /// @brief The type of handle used to access data read-only, then possibly mutably.
+    using HandleUpgradable = MustexUpgradableHandle<data_t, M>;
 
     template<typename... Args>
 #ifdef _MUSTEX_HAS_CONCEPTS
@@ -583,106 +2432,52 @@ public:
     Mustex &operator=(Mustex &&other) = delete;
 #endif // #ifdef _MUSTEX_HAS_CONCEPTS
 
-    virtual ~Mustex() = default;
+    ~Mustex() = default;
 
 private:
-#ifdef _MUSTEX_HAS_OPTIONAL
-    std::optional<Handle>
-#else
-    std::unique_ptr<Handle>
-#endif
-        try_lock_impl() const
+    detail::Optional<Handle> try_lock_impl() const
     {
         if (detail::proxy_mutex::try_lock_read(m_mutex))
-#ifdef _MUSTEX_HAS_OPTIONAL
-            return Handle(&m_mutex, &m_data);
-#else
-            return std::unique_ptr<Handle>(new Handle(&m_mutex, &m_data));
-#endif
+            return Handle(this);
         return {};
     }
 
     template<typename Rep, typename Period>
-#ifdef _MUSTEX_HAS_OPTIONAL
-    std::optional<Handle>
-#else
-    std::unique_ptr<Handle>
-#endif
-        try_lock_for_impl(const std::chrono::duration<Rep, Period> &d) const
+    detail::Optional<Handle> try_lock_for_impl(const std::chrono::duration<Rep, Period> &d) const
     {
         if (detail::proxy_mutex::try_lock_read_for(m_mutex, d))
-#ifdef _MUSTEX_HAS_OPTIONAL
-            return Handle(&m_mutex, &m_data);
-#else
-            return std::unique_ptr<Handle>(new Handle(&m_mutex, &m_data));
-#endif
+            return Handle(this);
         return {};
     }
 
     template<typename Clock, typename Duration>
-#ifdef _MUSTEX_HAS_OPTIONAL
-    std::optional<Handle>
-#else
-    std::unique_ptr<Handle>
-#endif
-        try_lock_until_impl(const std::chrono::time_point<Clock, Duration> &tp) const
+    detail::Optional<Handle> try_lock_until_impl(const std::chrono::time_point<Clock, Duration> &tp) const
     {
         if (detail::proxy_mutex::try_lock_read_until(m_mutex, tp))
-#ifdef _MUSTEX_HAS_OPTIONAL
-            return Handle(&m_mutex, &m_data);
-#else
-            return std::unique_ptr<Handle>(new Handle(&m_mutex, &m_data));
-#endif
+            return Handle(this);
         return {};
     }
 
-#ifdef _MUSTEX_HAS_OPTIONAL
-    std::optional<HandleMut>
-#else
-    std::unique_ptr<HandleMut>
-#endif
-        try_lock_mut_impl()
+    detail::Optional<HandleMut> try_lock_mut_impl()
     {
         if (detail::proxy_mutex::try_lock_write(m_mutex))
-#ifdef _MUSTEX_HAS_OPTIONAL
-            return HandleMut(&m_mutex, &m_data);
-#else
-            return std::unique_ptr<HandleMut>(new HandleMut(&m_mutex, &m_data));
-#endif
+            return HandleMut(this);
         return {};
     }
 
     template<typename Rep, typename Period>
-#ifdef _MUSTEX_HAS_OPTIONAL
-    std::optional<HandleMut>
-#else
-    std::unique_ptr<HandleMut>
-#endif
-        try_lock_mut_for_impl(const std::chrono::duration<Rep, Period> &d)
+    detail::Optional<HandleMut> try_lock_mut_for_impl(const std::chrono::duration<Rep, Period> &d)
     {
         if (detail::proxy_mutex::try_lock_write_for(m_mutex, d))
-#ifdef _MUSTEX_HAS_OPTIONAL
-            return HandleMut(&m_mutex, &m_data);
-#else
-            return std::unique_ptr<HandleMut>(new HandleMut(&m_mutex, &m_data));
-#endif
+            return HandleMut(this);
         return {};
     }
 
     template<typename Clock, typename Duration>
-#ifdef _MUSTEX_HAS_OPTIONAL
-    std::optional<HandleMut>
-#else
-    std::unique_ptr<HandleMut>
-#endif
-        try_lock_mut_until_impl(const std::chrono::time_point<Clock, Duration> &tp)
+    detail::Optional<HandleMut> try_lock_mut_until_impl(const std::chrono::time_point<Clock, Duration> &tp)
     {
         if (detail::proxy_mutex::try_lock_write_until(m_mutex, tp))
-#ifdef _MUSTEX_HAS_OPTIONAL
-            return HandleMut(&m_mutex, &m_data);
-#else
-            return std::unique_ptr<HandleMut>(new HandleMut(&m_mutex, &m_data));
-#endif
+            return HandleMut(this);
         return {};
     }
 
@@ -692,7 +2487,7 @@ public:
     Handle lock() const
     {
         detail::proxy_mutex::lock_read(m_mutex);
-        return Handle(&m_mutex, &m_data);
+        return Handle(this);
     }
 
     /// @brief Try to lock data for read-only access.
@@ -734,7 +2529,7 @@ public:
     HandleMut lock_mut()
     {
         detail::proxy_mutex::lock_write(m_mutex);
-        return HandleMut(&m_mutex, &m_data);
+        return HandleMut(this);
     }
 
     /// @brief Try to lock data for write access.
@@ -771,16 +2566,99 @@ public:
         return try_lock_mut_until_impl(tp);
     }
 
+    /// @brief Lock data for read-only access, with the option to atomically upgrade to write access.
+    /// Readers may access data meanwhile, but neither writers nor other upgradable handles.
+    /// Only available with mutexes that are UpgradeLockable, or have no readers.
+    /// @return Handle on owned data, see MustexUpgradableHandle::upgrade().
+    HandleUpgradable lock_upgradable()
+    {
+        static_assert(
+            detail::is_upgrade_lockable<M>::value || !detail::is_basic_shared_lockable<M>::value,
+            "Reader-writer mutex must be UpgradeLockable to lock for upgrade"
+        );
+        detail::proxy_mutex::lock_upgrade(m_mutex);
+        return HandleUpgradable(this);
+    }
+
+    /// @brief Try to lock data for read-only access, with the option to atomically upgrade to write
+    /// access.
+    /// @return Handle on owned data if available. Check before use.
+    detail::Optional<HandleUpgradable> try_lock_upgradable()
+    {
+        static_assert(
+            detail::is_upgrade_lockable<M>::value || !detail::is_basic_shared_lockable<M>::value,
+            "Reader-writer mutex must be UpgradeLockable to lock for upgrade"
+        );
+        if (detail::proxy_mutex::try_lock_upgrade(m_mutex))
+            return HandleUpgradable(this);
+        return {};
+    }
+
+    /// @brief Lock data for read-only access from a coroutine, which is suspended rather than its
+    /// thread blocked while the mutex is unavailable: `auto handle = co_await mustex.lock_async();`.
+    /// Only available with mutexes providing awaitables, such as AsyncMutex.
+    /// @param ...args Arguments of the mutex awaitable, such as the executor resuming the coroutine.
+    /// @return Awaitable producing a handle on owned data.
+    template<typename... Args, typename U = M>
+    auto lock_async(Args &&...args) const
+        -> detail::MustexAwaiter<decltype(detail::proxy_mutex::lock_read_async(std::declval<U &>(), std::forward<Args>(args)...)), const Mustex>
+    {
+        return {detail::proxy_mutex::lock_read_async(m_mutex, std::forward<Args>(args)...), this};
+    }
+
+    /// @brief Lock data for write access from a coroutine, which is suspended rather than its thread
+    /// blocked while the mutex is unavailable: `auto handle = co_await mustex.lock_mut_async();`.
+    /// Only available with mutexes providing awaitables, such as AsyncMutex.
+    /// @param ...args Arguments of the mutex awaitable, such as the executor resuming the coroutine.
+    /// @return Awaitable producing a handle on owned data.
+    template<typename... Args, typename U = M>
+    auto lock_mut_async(Args &&...args)
+        -> detail::MustexAwaiter<decltype(detail::proxy_mutex::lock_write_async(std::declval<U &>(), std::forward<Args>(args)...)), Mustex>
+    {
+        return {detail::proxy_mutex::lock_write_async(m_mutex, std::forward<Args>(args)...), this};
+    }
+
+    /// @brief Post a mutation to owned data without ever blocking on the mutex, applied right away if
+    /// the mutex is available, otherwise by the thread holding it once released, or by the next one
+    /// locking it for write access. Only available with mutexes accepting posted mutations, such as
+    /// WithPosting. The mutation is allocated on the heap, hence posting may block in the allocator.
+    /// @param f Callable accepting a `data_t &`, run by any thread, which should not throw.
+    template<typename F, typename U = M>
+    auto post(F f) -> decltype(std::declval<U &>().push_posted(std::declval<detail::PostedMutation *>()))
+    {
+        m_mutex.push_posted(new detail::PostedCall<data_t, F>(std::move(f)));
+        // Calling thread applies the mutation when releasing the mutex, do not try to lock it again.
+        if (m_mutex.is_held_by_this_thread())
+            return;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (detail::proxy_mutex::try_lock_write(m_mutex))
+        {
+            // Applies posted mutations, then releases the mutex.
+            HandleMut handle(this);
+        }
+    }
+
+    /// @brief Wait for mutations posted so far to be applied. Only available with mutexes
+    /// accepting posted mutations, such as WithPosting.
+    template<typename U = M>
+    auto flush() -> decltype(std::declval<U &>().push_posted(std::declval<detail::PostedMutation *>()))
+    {
+        lock_mut();
+    }
+
 private:
     T m_data;
     mutable M m_mutex;
 
-    // These are necessary in order for bcx::lock_mut to work.
-    template<typename U>
-    friend auto detail::get_mutex_ref(U &m) -> typename std::enable_if<detail::is_mustex<U>::value, typename U::mutex_t &>::type;
-    template<template<class> class _WL, typename U>
-    friend auto detail::adopt_lock(U &m) -> typename std::enable_if<detail::is_mustex<U>::value, typename U::HandleMut>::type;
-    HandleMut lock_mut(std::adopt_lock_t) { return HandleMut(&m_mutex, &m_data); }
+    template<typename, class, class>
+    friend class MustexHandle;
+    template<typename, class>
+    friend class MustexUpgradableHandle;
+
+    // This is necessary in order for bcx::lock_mut and bcx::lock to work.
+    friend struct detail::MustexAccess;
+    Handle lock(std::adopt_lock_t) const { return Handle(this); }
+    HandleMut lock_mut(std::adopt_lock_t) { return HandleMut(this); }
 };
 } // namespace bcx
 
@@ -0,0 +1,240 @@
+#ifndef BCX_PARKING_LOT_MUTEX_HPP
+#define BCX_PARKING_LOT_MUTEX_HPP
+
+#include "mustex.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+
+namespace bcx
+{
+
+namespace detail
+{
+/// @brief Global table of wait queues, keyed by address, where threads waiting on any lock park.
+/// Locks hence do not need to hold any waiting machinery, only enough state to know whether some
+/// thread is parked on them.
+class ParkingLot
+{
+public:
+    /// @brief Park calling thread on `address` if `validate()` is true, until unparked or the
+    /// deadline, if any, is reached. `validate()` is called while the queue of `address` is locked,
+    /// hence cannot race with unpark_one().
+    /// @return True if the thread was unparked, false if validation failed or the deadline was reached.
+    template<typename Validate, typename Clock, typename Duration>
+    static bool park(const void *address, Validate validate, const std::chrono::time_point<Clock, Duration> *tp)
+    {
+        Waiter &self = this_thread_waiter();
+        Bucket &bucket = bucket_for(address);
+        {
+            std::lock_guard<std::mutex> lock(bucket.mutex);
+            if (!validate())
+                return false;
+            self.address = address;
+            self.next = nullptr;
+            self.unparked.store(0, std::memory_order_relaxed);
+            if (bucket.tail)
+                bucket.tail->next = &self;
+            else
+                bucket.head = &self;
+            bucket.tail = &self;
+        }
+        while (!self.unparked.load(std::memory_order_acquire))
+        {
+            if (!tp)
+            {
+                futex_wait(self.unparked, 0);
+            }
+            else if (!futex_wait_until(self.unparked, 0, *tp))
+            {
+                std::lock_guard<std::mutex> lock(bucket.mutex);
+                // Unless unparked meanwhile, in which case the flag is already set.
+                if (remove(bucket, self))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+    /// @brief Unpark the first thread parked on `address`, if any.
+    /// `callback(bool more)` is called while the queue of `address` is locked, before the thread is
+    /// actually woken up, `more` telling whether other threads are still parked on `address`.
+    template<typename Callback>
+    static void unpark_one(const void *address, Callback callback)
+    {
+        Bucket &bucket = bucket_for(address);
+        Waiter *woken = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(bucket.mutex);
+            bool more = false;
+            for (Waiter *waiter = bucket.head; waiter; waiter = waiter->next)
+            {
+                if (waiter->address != address)
+                    continue;
+                if (woken)
+                {
+                    more = true;
+                    break;
+                }
+                woken = waiter;
+            }
+            if (woken)
+                remove(bucket, *woken);
+            callback(more);
+            if (woken)
+                woken->unparked.store(1, std::memory_order_release);
+        }
+        // The woken thread may already be gone, its waiter being thread local this is harmless.
+        if (woken)
+            futex_wake_one(woken->unparked);
+    }
+
+private:
+    /// @brief A parked thread, one per thread for its whole lifetime.
+    struct Waiter
+    {
+        const void *address = nullptr;
+        Waiter *next = nullptr;
+        std::atomic<std::uint32_t> unparked{0};
+    };
+
+    struct Bucket
+    {
+        std::mutex mutex;
+        Waiter *head = nullptr;
+        Waiter *tail = nullptr;
+    };
+
+    static constexpr std::size_t BUCKETS = 256;
+
+    static Waiter &this_thread_waiter()
+    {
+        static thread_local Waiter waiter;
+        return waiter;
+    }
+
+    static Bucket &bucket_for(const void *address)
+    {
+        static Bucket buckets[BUCKETS];
+        const std::uintptr_t key = reinterpret_cast<std::uintptr_t>(address);
+        return buckets[(key ^ (key >> 8) ^ (key >> 16)) % BUCKETS];
+    }
+
+    /// @brief Remove waiter from bucket queue, which must be locked.
+    /// @return False if the waiter was not queued.
+    static bool remove(Bucket &bucket, Waiter &waiter)
+    {
+        Waiter *previous = nullptr;
+        for (Waiter *current = bucket.head; current; previous = current, current = current->next)
+        {
+            if (current != &waiter)
+                continue;
+            (previous ? previous->next : bucket.head) = current->next;
+            if (bucket.tail == current)
+                bucket.tail = previous;
+            return true;
+        }
+        return false;
+    }
+};
+} // namespace detail
+
+/// @brief Exclusive mutex whose whole state is a single byte, for many small objects.
+/// Threads waiting for the mutex park in a global table of wait queues shared by all instances,
+/// keyed by the address of the mutex, so that the mutex itself only holds whether it is locked
+/// and whether some thread is parked on it. Contended threads spin shortly before parking.
+/// Meets the TimedLockable requirements, and can be used as `Mustex<T, ParkingLotMutex>`. Readers
+/// are then exclusive too.
+class ParkingLotMutex
+{
+public:
+    ParkingLotMutex() = default;
+    ParkingLotMutex(const ParkingLotMutex &) = delete;
+    ParkingLotMutex &operator=(const ParkingLotMutex &) = delete;
+
+    void lock()
+    {
+        if (!try_lock())
+            lock_slow<std::chrono::steady_clock, std::chrono::steady_clock::duration>(nullptr);
+    }
+
+    bool try_lock()
+    {
+        std::uint8_t state = m_state.load(std::memory_order_relaxed);
+        while (!(state & LOCKED))
+            if (m_state.compare_exchange_weak(state, state | LOCKED, std::memory_order_acquire, std::memory_order_relaxed))
+                return true;
+        return false;
+    }
+
+    template<typename Rep, typename Period>
+    bool try_lock_for(const std::chrono::duration<Rep, Period> &d)
+    {
+        return try_lock_until(std::chrono::steady_clock::now() + d);
+    }
+
+    template<typename Clock, typename Duration>
+    bool try_lock_until(const std::chrono::time_point<Clock, Duration> &tp)
+    {
+        return try_lock() || lock_slow(&tp);
+    }
+
+    void unlock()
+    {
+        std::uint8_t expected = LOCKED;
+        if (m_state.compare_exchange_strong(expected, 0, std::memory_order_release, std::memory_order_relaxed))
+            return;
+        // Some thread is parked, hand the mutex back while its queue is locked so that no thread can
+        // park in between.
+        detail::ParkingLot::unpark_one(
+            this,
+            [this](bool more) { m_state.store(more ? PARKED : 0, std::memory_order_release); }
+        );
+    }
+
+private:
+    static constexpr std::uint8_t LOCKED = 1;
+    static constexpr std::uint8_t PARKED = 2;
+
+    /// @brief Spin then park until the mutex is acquired or the deadline, if any, is reached.
+    template<typename Clock, typename Duration>
+    bool lock_slow(const std::chrono::time_point<Clock, Duration> *tp)
+    {
+        detail::Backoff backoff;
+        std::uint8_t state = m_state.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            if (!(state & LOCKED))
+            {
+                if (m_state.compare_exchange_weak(state, state | LOCKED, std::memory_order_acquire, std::memory_order_relaxed))
+                    return true;
+                continue;
+            }
+            if (backoff.is_spinning())
+            {
+                backoff.pause();
+                state = m_state.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (!(state & PARKED) && !m_state.compare_exchange_weak(state, state | PARKED, std::memory_order_relaxed))
+                continue;
+            if (tp && Clock::now() >= *tp)
+                return false;
+            detail::ParkingLot::park(
+                this,
+                [this] { return m_state.load(std::memory_order_relaxed) == (LOCKED | PARKED); },
+                tp
+            );
+            state = m_state.load(std::memory_order_relaxed);
+        }
+    }
+
+    /// @brief Locked bit and parked bit.
+    std::atomic<std::uint8_t> m_state{0};
+};
+
+} // namespace bcx
+
+#endif // #ifndef BCX_PARKING_LOT_MUTEX_HPP
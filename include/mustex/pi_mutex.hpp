@@ -0,0 +1,117 @@
+#ifndef BCX_PI_MUTEX_HPP
+#define BCX_PI_MUTEX_HPP
+
+#include "mustex.hpp"
+
+#if defined(__linux__)
+#    define _MUSTEX_HAS_PI_MUTEX
+#    include <pthread.h>
+#    include <cerrno>
+#    include <ctime>
+#    include <system_error>
+#endif // #if defined(__linux__)
+
+#include <chrono>
+
+#ifdef _MUSTEX_HAS_PI_MUTEX
+namespace bcx
+{
+
+/// @brief Exclusive mutex with priority inheritance, for sharing data with latency-critical threads.
+/// While a thread waits for the mutex, the thread holding it runs with at least the priority of the
+/// waiting thread, so that a low priority holder cannot be preempted by medium priority threads
+/// while a high priority thread waits (priority inversion). Only available on Linux, where
+/// `_MUSTEX_HAS_PI_MUTEX` is defined.
+/// As std::mutex, lock() throws std::system_error on failure, and the mutex must be unlocked by
+/// the thread that locked it.
+/// Meets the TimedLockable requirements, and can be used as `Mustex<T, PiMutex>`. Readers are then
+/// exclusive too.
+class PiMutex
+{
+public:
+    using native_handle_type = pthread_mutex_t *;
+
+    PiMutex()
+    {
+        pthread_mutexattr_t attributes;
+        int error = pthread_mutexattr_init(&attributes);
+        if (!error)
+        {
+            error = pthread_mutexattr_setprotocol(&attributes, PTHREAD_PRIO_INHERIT);
+            if (!error)
+                error = pthread_mutex_init(&m_mutex, &attributes);
+            pthread_mutexattr_destroy(&attributes);
+        }
+        if (error)
+            throw std::system_error(error, std::system_category(), "PiMutex");
+    }
+
+    PiMutex(const PiMutex &) = delete;
+    PiMutex &operator=(const PiMutex &) = delete;
+
+    ~PiMutex()
+    {
+        pthread_mutex_destroy(&m_mutex);
+    }
+
+    void lock()
+    {
+        const int error = pthread_mutex_lock(&m_mutex);
+        if (error)
+            throw std::system_error(error, std::system_category(), "PiMutex::lock");
+    }
+
+    bool try_lock()
+    {
+        return pthread_mutex_trylock(&m_mutex) == 0;
+    }
+
+    template<typename Rep, typename Period>
+    bool try_lock_for(const std::chrono::duration<Rep, Period> &d)
+    {
+        return try_lock_until(std::chrono::steady_clock::now() + d);
+    }
+
+    template<typename Clock, typename Duration>
+    bool try_lock_until(const std::chrono::time_point<Clock, Duration> &tp)
+    {
+        // Priority inheritance waits are measured against the system clock, deadlines on other
+        // clocks are converted and checked again on timeout in case the clocks drifted.
+        for (;;)
+        {
+            const auto remaining = tp - Clock::now();
+            if (remaining <= Duration::zero())
+                return try_lock();
+            const auto deadline = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                (std::chrono::system_clock::now() + remaining).time_since_epoch()
+            );
+            const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(deadline);
+            timespec ts;
+            ts.tv_sec = static_cast<decltype(ts.tv_sec)>(seconds.count());
+            ts.tv_nsec = static_cast<decltype(ts.tv_nsec)>((deadline - seconds).count());
+            const int error = pthread_mutex_timedlock(&m_mutex, &ts);
+            if (!error)
+                return true;
+            if (error != ETIMEDOUT)
+                throw std::system_error(error, std::system_category(), "PiMutex::try_lock_until");
+        }
+    }
+
+    void unlock()
+    {
+        pthread_mutex_unlock(&m_mutex);
+    }
+
+    native_handle_type native_handle()
+    {
+        return &m_mutex;
+    }
+
+private:
+    pthread_mutex_t m_mutex;
+};
+
+} // namespace bcx
+#endif // #ifdef _MUSTEX_HAS_PI_MUTEX
+
+#endif // #ifndef BCX_PI_MUTEX_HPP
@@ -0,0 +1,142 @@
+#ifndef BCX_POSTING_MUTEX_HPP
+#define BCX_POSTING_MUTEX_HPP
+
+#include "mustex.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <utility>
+
+namespace bcx
+{
+
+/// @brief Mutex M accepting mutations posted to its Mustex without blocking, see Mustex::post().
+/// Posted mutations are pushed onto a lock-free stack, and applied in posting order by the next
+/// thread holding the mutex for write access: the posting thread itself if the mutex is available,
+/// otherwise the thread holding it when releasing it, or the next one locking it for write access.
+/// Hence `lock_mut()` and `flush()` always see all mutations posted before.
+/// The thread holding the mutex for write access is tracked, so that posting from it does not try
+/// to lock the mutex again. Posting while holding it for read or upgrade access requires M to fail
+/// trying to lock it for write access then, as the mutexes of this library do, unlike
+/// std::shared_mutex.
+/// Meets the same requirements as M, and can be used as `Mustex<T, WithPosting<M>>`.
+template<class M>
+class WithPosting : public detail::MutexWrapper<M>
+{
+public:
+    WithPosting() = default;
+
+    ~WithPosting()
+    {
+        detail::PostedMutation *mutation = take_posted();
+        while (mutation)
+        {
+            detail::PostedMutation *next = mutation->next;
+            mutation->apply(*mutation, nullptr);
+            mutation = next;
+        }
+    }
+
+    void lock()
+    {
+        this->m_mutex.lock();
+        m_writer.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    }
+
+    template<typename U = M>
+    auto try_lock() -> decltype(std::declval<U &>().try_lock())
+    {
+        return acquired(this->m_mutex.try_lock());
+    }
+
+    template<typename Rep, typename Period, typename U = M>
+    auto try_lock_for(const std::chrono::duration<Rep, Period> &d) -> decltype(std::declval<U &>().try_lock_for(d))
+    {
+        return acquired(this->m_mutex.try_lock_for(d));
+    }
+
+    template<typename Clock, typename Duration, typename U = M>
+    auto try_lock_until(const std::chrono::time_point<Clock, Duration> &tp)
+        -> decltype(std::declval<U &>().try_lock_until(tp))
+    {
+        return acquired(this->m_mutex.try_lock_until(tp));
+    }
+
+    void unlock()
+    {
+        m_writer.store(std::thread::id(), std::memory_order_relaxed);
+        this->m_mutex.unlock();
+    }
+
+    template<typename U = M>
+    auto unlock_upgrade_and_lock() -> decltype(std::declval<U &>().unlock_upgrade_and_lock())
+    {
+        this->m_mutex.unlock_upgrade_and_lock();
+        m_writer.store(std::this_thread::get_id(), std::memory_order_relaxed);
+    }
+
+    template<typename U = M>
+    auto unlock_and_lock_shared() -> decltype(std::declval<U &>().unlock_and_lock_shared())
+    {
+        m_writer.store(std::thread::id(), std::memory_order_relaxed);
+        this->m_mutex.unlock_and_lock_shared();
+    }
+
+    /// @brief Queue given mutation up, never blocks.
+    void push_posted(detail::PostedMutation *mutation)
+    {
+        detail::PostedMutation *head = m_posted.load(std::memory_order_relaxed);
+        do
+        {
+            mutation->next = head;
+        } while (!m_posted.compare_exchange_weak(head, mutation, std::memory_order_release, std::memory_order_relaxed));
+    }
+
+    /// @brief Dequeue all posted mutations.
+    /// @return Mutations in posting order, linked by their `next` member.
+    detail::PostedMutation *take_posted()
+    {
+        detail::PostedMutation *stack = m_posted.exchange(nullptr, std::memory_order_acquire);
+        detail::PostedMutation *queue = nullptr;
+        while (stack)
+        {
+            detail::PostedMutation *next = stack->next;
+            stack->next = queue;
+            queue = stack;
+            stack = next;
+        }
+        return queue;
+    }
+
+    bool has_posted() const
+    {
+        return m_posted.load(std::memory_order_relaxed) != nullptr;
+    }
+
+    /// @brief Whether calling thread holds the mutex for write access, and applies posted mutations
+    /// when releasing it.
+    bool is_held_by_this_thread() const
+    {
+        // Only calling thread stores its own id, and clears it before unlocking.
+        return m_writer.load(std::memory_order_relaxed) == std::this_thread::get_id();
+    }
+
+private:
+    /// @brief Thread holding the mutex for write access, if any.
+    std::atomic<std::thread::id> m_writer{std::thread::id()};
+
+    /// @brief Posted mutations, last posted first.
+    std::atomic<detail::PostedMutation *> m_posted{nullptr};
+
+    bool acquired(bool success)
+    {
+        if (success)
+            m_writer.store(std::this_thread::get_id(), std::memory_order_relaxed);
+        return success;
+    }
+};
+
+} // namespace bcx
+
+#endif // #ifndef BCX_POSTING_MUTEX_HPP
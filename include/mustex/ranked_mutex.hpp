@@ -0,0 +1,185 @@
+#ifndef BCX_RANKED_MUTEX_HPP
+#define BCX_RANKED_MUTEX_HPP
+
+#include "mustex.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <utility>
+
+#ifndef NDEBUG
+#    include <cassert>
+#    include <vector>
+#endif // #ifndef NDEBUG
+
+namespace bcx
+{
+
+namespace detail
+{
+/// @brief Ranks of the Ranked mutexes held by calling thread, only tracked in debug builds.
+class HeldRanks
+{
+public:
+    /// @brief Check that calling thread may block on a mutex of given rank, that is it holds no
+    /// mutex of greater or equal rank, otherwise two threads could wait for each other.
+    static void check_blocking(std::size_t rank)
+    {
+#ifndef NDEBUG
+        for (std::size_t held : ranks())
+            assert(held < rank && "Ranked mutex locked while holding a mutex of greater or equal rank");
+#else // #ifndef NDEBUG
+        (void)rank;
+#endif // #ifndef NDEBUG
+    }
+
+    static void add(std::size_t rank)
+    {
+#ifndef NDEBUG
+        ranks().push_back(rank);
+#else // #ifndef NDEBUG
+        (void)rank;
+#endif // #ifndef NDEBUG
+    }
+
+    static void remove(std::size_t rank)
+    {
+#ifndef NDEBUG
+        std::vector<std::size_t> &held = ranks();
+        for (std::size_t i = held.size(); i--;)
+        {
+            if (held[i] != rank)
+                continue;
+            held.erase(held.begin() + static_cast<std::ptrdiff_t>(i));
+            return;
+        }
+#else // #ifndef NDEBUG
+        (void)rank;
+#endif // #ifndef NDEBUG
+    }
+
+private:
+#ifndef NDEBUG
+    static std::vector<std::size_t> &ranks()
+    {
+        static thread_local std::vector<std::size_t> held;
+        return held;
+    }
+#endif // #ifndef NDEBUG
+};
+} // namespace detail
+
+/// @brief Mutex M given a static rank N, for locking several Mustex in a fixed order.
+/// bcx::lock_mut() and bcx::lock() acquire Mustex whose mutexes all have a rank one after another in
+/// increasing rank order, computed at compile time, instead of relying on std::lock() deadlock
+/// avoidance and its retries. Ranks of Mustex locked together must be distinct, which is checked at
+/// compile time. In debug builds, a thread blocking on a ranked mutex while holding one of greater
+/// or equal rank fails an assertion, try and timed acquisitions being allowed in any order.
+/// Upgrading and downgrading only wait for readers of this mutex, held ranks are left unchanged.
+/// Meets the same requirements as M, and can be used as `Mustex<T, Ranked<M, N>>`.
+template<class M, std::size_t N>
+class Ranked : public detail::MutexWrapper<M>
+{
+public:
+    static constexpr std::size_t rank = N;
+
+    void lock()
+    {
+        detail::HeldRanks::check_blocking(N);
+        this->m_mutex.lock();
+        detail::HeldRanks::add(N);
+    }
+
+    template<typename U = M>
+    auto try_lock() -> decltype(std::declval<U &>().try_lock())
+    {
+        return acquired(this->m_mutex.try_lock());
+    }
+
+    template<typename Rep, typename Period, typename U = M>
+    auto try_lock_for(const std::chrono::duration<Rep, Period> &d) -> decltype(std::declval<U &>().try_lock_for(d))
+    {
+        return acquired(this->m_mutex.try_lock_for(d));
+    }
+
+    template<typename Clock, typename Duration, typename U = M>
+    auto try_lock_until(const std::chrono::time_point<Clock, Duration> &tp)
+        -> decltype(std::declval<U &>().try_lock_until(tp))
+    {
+        return acquired(this->m_mutex.try_lock_until(tp));
+    }
+
+    void unlock()
+    {
+        this->m_mutex.unlock();
+        detail::HeldRanks::remove(N);
+    }
+
+    template<typename U = M>
+    auto lock_shared() -> decltype(std::declval<U &>().lock_shared())
+    {
+        detail::HeldRanks::check_blocking(N);
+        this->m_mutex.lock_shared();
+        detail::HeldRanks::add(N);
+    }
+
+    template<typename U = M>
+    auto try_lock_shared() -> decltype(std::declval<U &>().try_lock_shared())
+    {
+        return acquired(this->m_mutex.try_lock_shared());
+    }
+
+    template<typename Rep, typename Period, typename U = M>
+    auto try_lock_shared_for(const std::chrono::duration<Rep, Period> &d)
+        -> decltype(std::declval<U &>().try_lock_shared_for(d))
+    {
+        return acquired(this->m_mutex.try_lock_shared_for(d));
+    }
+
+    template<typename Clock, typename Duration, typename U = M>
+    auto try_lock_shared_until(const std::chrono::time_point<Clock, Duration> &tp)
+        -> decltype(std::declval<U &>().try_lock_shared_until(tp))
+    {
+        return acquired(this->m_mutex.try_lock_shared_until(tp));
+    }
+
+    template<typename U = M>
+    auto unlock_shared() -> decltype(std::declval<U &>().unlock_shared())
+    {
+        this->m_mutex.unlock_shared();
+        detail::HeldRanks::remove(N);
+    }
+
+    template<typename U = M>
+    auto lock_upgrade() -> decltype(std::declval<U &>().lock_upgrade())
+    {
+        detail::HeldRanks::check_blocking(N);
+        this->m_mutex.lock_upgrade();
+        detail::HeldRanks::add(N);
+    }
+
+    template<typename U = M>
+    auto try_lock_upgrade() -> decltype(std::declval<U &>().try_lock_upgrade())
+    {
+        return acquired(this->m_mutex.try_lock_upgrade());
+    }
+
+    template<typename U = M>
+    auto unlock_upgrade() -> decltype(std::declval<U &>().unlock_upgrade())
+    {
+        this->m_mutex.unlock_upgrade();
+        detail::HeldRanks::remove(N);
+    }
+
+private:
+    static bool acquired(bool success)
+    {
+        if (success)
+            detail::HeldRanks::add(N);
+        return success;
+    }
+};
+
+} // namespace bcx
+
+#endif // #ifndef BCX_RANKED_MUTEX_HPP
@@ -0,0 +1,487 @@
+#ifndef BCX_RCU_MUSTEX_HPP
+#define BCX_RCU_MUSTEX_HPP
+
+#include "mustex.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace bcx
+{
+
+// Forward declares
+template<typename T, class M>
+class RcuMustex;
+
+namespace detail
+{
+/// @brief Epoch announced by a reading thread, alone on its cache line.
+struct RcuReaderSlot
+{
+    char padding_front[64];
+    /// @brief Epoch at which the owning thread started reading, 0 when not reading.
+    std::atomic<uint64_t> epoch{0};
+    /// @brief Whether a thread currently owns this slot.
+    std::atomic<bool> in_use{true};
+    /// @brief Number of nested read-side sections of owning thread, only accessed by that thread.
+    unsigned nesting = 0;
+    /// @brief Next slot in the registry, slots are never freed.
+    RcuReaderSlot *next = nullptr;
+    char padding_back[64];
+};
+
+/// @brief Process-wide epoch-based reclamation domain, shared by all RcuMustex.
+class RcuDomain
+{
+public:
+    static RcuDomain &instance()
+    {
+        static RcuDomain domain;
+        return domain;
+    }
+
+    uint64_t epoch() const
+    {
+        return m_epoch.load(std::memory_order_seq_cst);
+    }
+
+    /// @brief Start a new epoch.
+    /// @return The epoch that just ended.
+    uint64_t advance()
+    {
+        return m_epoch.fetch_add(1, std::memory_order_seq_cst);
+    }
+
+    /// @brief Check whether every reader that may have seen data retired during given epoch is done.
+    bool is_quiescent_since(uint64_t epoch) const
+    {
+        for (RcuReaderSlot *slot = m_slots.load(std::memory_order_acquire); slot; slot = slot->next)
+        {
+            const uint64_t reader_epoch = slot->epoch.load(std::memory_order_seq_cst);
+            if (reader_epoch != 0 && reader_epoch <= epoch)
+                return false;
+        }
+        return true;
+    }
+
+    /// @brief Get a slot for calling thread, reusing the one of an exited thread if possible.
+    RcuReaderSlot *acquire_slot()
+    {
+        for (RcuReaderSlot *slot = m_slots.load(std::memory_order_acquire); slot; slot = slot->next)
+        {
+            bool in_use = false;
+            if (!slot->in_use.load(std::memory_order_relaxed) && slot->in_use.compare_exchange_strong(in_use, true))
+                return slot;
+        }
+        RcuReaderSlot *slot = new RcuReaderSlot;
+        slot->next = m_slots.load(std::memory_order_relaxed);
+        while (!m_slots.compare_exchange_weak(slot->next, slot, std::memory_order_release, std::memory_order_relaxed))
+            ;
+        return slot;
+    }
+
+    void release_slot(RcuReaderSlot *slot)
+    {
+        slot->in_use.store(false, std::memory_order_release);
+    }
+
+private:
+    RcuDomain() = default;
+
+    /// @brief Current epoch, starting at 1 since 0 denotes idle readers.
+    std::atomic<uint64_t> m_epoch{1};
+    std::atomic<RcuReaderSlot *> m_slots{nullptr};
+};
+
+/// @brief Owner of calling thread's reader slot, giving it back when the thread exits.
+class RcuThreadSlot
+{
+public:
+    ~RcuThreadSlot()
+    {
+        if (m_slot)
+            RcuDomain::instance().release_slot(m_slot);
+    }
+
+    static RcuReaderSlot &get()
+    {
+        static thread_local RcuThreadSlot holder;
+        if (!holder.m_slot)
+            holder.m_slot = RcuDomain::instance().acquire_slot();
+        return *holder.m_slot;
+    }
+
+private:
+    RcuReaderSlot *m_slot = nullptr;
+};
+
+/// @brief Enter a read-side section, only writing to calling thread's slot.
+inline RcuReaderSlot *rcu_read_lock()
+{
+    RcuReaderSlot &slot = RcuThreadSlot::get();
+    if (slot.nesting++ == 0)
+        slot.epoch.store(RcuDomain::instance().epoch(), std::memory_order_seq_cst);
+    return &slot;
+}
+
+/// @brief Leave a read-side section, on the thread that entered it.
+inline void rcu_read_unlock(RcuReaderSlot *slot)
+{
+    if (--slot->nesting == 0)
+        slot->epoch.store(0, std::memory_order_release);
+}
+} // namespace detail
+
+/// @brief Mutable access to RcuMustex data, mirroring MustexHandle.
+/// The handle works on a private copy of the data, published to readers when dropped.
+/// @tparam T Type of data to be accessed.
+/// @tparam M Type of mutex serializing writers.
+template<typename T, class M>
+class RcuMustexHandle
+{
+public:
+    // Only parent RcuMustex can instantiate this class.
+    template<class MT, class MM>
+    friend class RcuMustex;
+
+    /// @brief The type of contained value, exposed for convenience.
+    using data_t = typename std::remove_cv<T>::type;
+
+    RcuMustexHandle() = delete;
+    RcuMustexHandle(const RcuMustexHandle &) = delete;
+    RcuMustexHandle(RcuMustexHandle &&other)
+        : m_owner{other.m_owner}
+        , m_data{other.m_data}
+    {
+        other.m_owner = nullptr;
+        other.m_data = nullptr;
+    }
+
+    RcuMustexHandle &operator=(const RcuMustexHandle &other) = delete;
+    RcuMustexHandle &operator=(RcuMustexHandle &&other)
+    {
+        unlock();
+        m_owner = other.m_owner;
+        other.m_owner = nullptr;
+        m_data = other.m_data;
+        other.m_data = nullptr;
+        return *this;
+    }
+
+    ~RcuMustexHandle()
+    {
+        unlock();
+    }
+
+    T &operator*()
+    {
+        return *m_data;
+    }
+
+    T *operator->()
+    {
+        return m_data;
+    }
+
+private:
+    RcuMustex<data_t, M> *m_owner;
+    data_t *m_data;
+
+    /// @brief Create handle on ALREADY ACQUIRED writer mutex, taking ownership of the copy.
+    RcuMustexHandle(RcuMustex<data_t, M> *owner, data_t *data)
+        : m_owner{owner}
+        , m_data{data}
+    {
+    }
+
+    void unlock()
+    {
+        if (!m_owner)
+            return;
+        m_owner->publish(m_data);
+        detail::proxy_mutex::unlock_write(m_owner->m_mutex);
+    }
+};
+
+/// @brief Read-only access to RcuMustex data, mirroring MustexHandle.
+/// The handle pins the version of the data that was current when created, and must be dropped by
+/// the thread that created it.
+/// @tparam T Type of data to be accessed.
+/// @tparam M Type of mutex serializing writers.
+template<typename T, class M>
+class RcuMustexHandle<const T, M>
+{
+public:
+    // Only parent RcuMustex can instantiate this class.
+    template<class MT, class MM>
+    friend class RcuMustex;
+
+    /// @brief The type of contained value, exposed for convenience.
+    using data_t = typename std::remove_cv<T>::type;
+
+    RcuMustexHandle() = delete;
+    RcuMustexHandle(const RcuMustexHandle &) = delete;
+    RcuMustexHandle(RcuMustexHandle &&other)
+        : m_slot{other.m_slot}
+        , m_data{other.m_data}
+    {
+        other.m_slot = nullptr;
+        other.m_data = nullptr;
+    }
+
+    RcuMustexHandle &operator=(const RcuMustexHandle &other) = delete;
+    RcuMustexHandle &operator=(RcuMustexHandle &&other)
+    {
+        unlock();
+        m_slot = other.m_slot;
+        other.m_slot = nullptr;
+        m_data = other.m_data;
+        other.m_data = nullptr;
+        return *this;
+    }
+
+    ~RcuMustexHandle()
+    {
+        unlock();
+    }
+
+    const T &operator*() const
+    {
+        return *m_data;
+    }
+
+    const T *operator->() const
+    {
+        return m_data;
+    }
+
+private:
+    detail::RcuReaderSlot *m_slot;
+    const T *m_data;
+
+    /// @brief Create handle on ALREADY ENTERED read-side section.
+    RcuMustexHandle(detail::RcuReaderSlot *slot, const T *data)
+        : m_slot{slot}
+        , m_data{data}
+    {
+    }
+
+    void unlock()
+    {
+        if (!m_slot)
+            return;
+        detail::rcu_read_unlock(m_slot);
+    }
+};
+
+/// @brief Data-owning read-copy-update synchronization, for read-mostly data.
+/// Readers access the current version of the data without writing to shared memory nor blocking.
+/// Writers are serialized by a mutex, modify a copy of the data and publish it when their handle is
+/// dropped. Replaced versions are reclaimed once every reader that may still access them is done.
+/// @tparam T The type of data to be shared among threads, must be copy constructible.
+/// @tparam M Type of mutex serializing writers.
+template<class T, class M = std::timed_mutex>
+class RcuMustex
+{
+public:
+    /// @brief The type of contained value, exposed for convenience.
+    using data_t = typename std::remove_cv<T>::type;
+    /// @brief The type of mutex used, exposed for convenience.
+    using mutex_t = M;
+    /// @brief The type of handle used to access data.
+    using Handle = RcuMustexHandle<const data_t, M>;
+    /// @brief The type of handle used to access data mutably.
+    using HandleMut = RcuMustexHandle<data_t, M>;
+
+    template<typename... Args>
+    RcuMustex(Args &&...args)
+        : m_current{new data_t(std::forward<Args>(args)...)}
+        , m_mutex{}
+    {
+    }
+
+    RcuMustex(const RcuMustex &) = delete;
+    RcuMustex(RcuMustex &&other) = delete;
+    RcuMustex &operator=(const RcuMustex &other) = delete;
+    RcuMustex &operator=(RcuMustex &&other) = delete;
+
+    /// @brief Destroy all versions of data, no handle may outlive the RcuMustex.
+    ~RcuMustex()
+    {
+        delete m_current.load(std::memory_order_relaxed);
+        for (const Retired &retired : m_retired)
+            delete retired.data;
+    }
+
+private:
+    using OptionalHandle = detail::Optional<Handle>;
+    using OptionalHandleMut = detail::Optional<HandleMut>;
+
+    /// @brief Replaced version of data, along with the epoch it was replaced in.
+    struct Retired
+    {
+        data_t *data;
+        uint64_t epoch;
+    };
+
+    /// @brief Publish new version of data, writer mutex must be held and room reserved in
+    /// `m_retired`, so that it cannot throw.
+    void publish(data_t *data)
+    {
+        data_t *previous = m_current.exchange(data, std::memory_order_seq_cst);
+        Retired retired;
+        retired.data = previous;
+        retired.epoch = detail::RcuDomain::instance().advance();
+        m_retired.push_back(retired);
+        reclaim();
+    }
+
+    /// @brief Destroy replaced versions no reader can access anymore, writer mutex must be held.
+    void reclaim()
+    {
+        const detail::RcuDomain &domain = detail::RcuDomain::instance();
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i < m_retired.size(); ++i)
+        {
+            if (domain.is_quiescent_since(m_retired[i].epoch))
+                delete m_retired[i].data;
+            else
+                m_retired[kept++] = m_retired[i];
+        }
+        m_retired.resize(kept);
+    }
+
+    /// @brief Create writer handle on a copy of current version, writer mutex must be held.
+    HandleMut make_handle_mut()
+    {
+        std::unique_lock<M> guard(m_mutex, std::adopt_lock);
+        // Room for the version replaced on publication, which runs from the handle's destructor.
+        if (m_retired.size() == m_retired.capacity())
+            m_retired.reserve(2 * m_retired.size() + 1);
+        data_t *copy = new data_t(*m_current.load(std::memory_order_relaxed));
+        guard.release();
+        return HandleMut(this, copy);
+    }
+
+    OptionalHandle make_optional() const
+    {
+        return lock();
+    }
+
+    OptionalHandleMut make_optional_mut()
+    {
+        return make_handle_mut();
+    }
+
+public:
+    /// @brief Access current version of data for read-only access. Never blocks.
+    /// The returned handle must be dropped by calling thread.
+    /// @return Handle on current version of owned data.
+    Handle lock() const
+    {
+        detail::RcuReaderSlot *slot = detail::rcu_read_lock();
+        return Handle(slot, m_current.load(std::memory_order_seq_cst));
+    }
+
+    /// @brief Access current version of data for read-only access, provided for Mustex parity.
+    /// @return Handle on current version of owned data, always available.
+    OptionalHandle try_lock() const
+    {
+        return make_optional();
+    }
+
+    /// @brief Access current version of data for read-only access, provided for Mustex parity.
+    /// @return Handle on current version of owned data, always available.
+    OptionalHandle lock(std::try_to_lock_t) const
+    {
+        return try_lock();
+    }
+
+    /// @brief Access current version of data for read-only access, provided for Mustex parity.
+    /// @return Handle on current version of owned data, always available.
+    template<typename Rep, typename Period>
+    OptionalHandle try_lock_for(const std::chrono::duration<Rep, Period> &) const
+    {
+        return try_lock();
+    }
+
+    /// @brief Access current version of data for read-only access, provided for Mustex parity.
+    /// @return Handle on current version of owned data, always available.
+    template<typename Clock, typename Duration>
+    OptionalHandle try_lock_until(const std::chrono::time_point<Clock, Duration> &) const
+    {
+        return try_lock();
+    }
+
+    /// @brief Lock data for write access. Readers are not blocked and keep seeing the current
+    /// version until handle is dropped.
+    /// @return Handle on a copy of current version, published when dropped.
+    HandleMut lock_mut()
+    {
+        detail::proxy_mutex::lock_write(m_mutex);
+        return make_handle_mut();
+    }
+
+    /// @brief Try to lock data for write access.
+    /// @return Handle on a copy of current version if available. Check before use.
+    OptionalHandleMut try_lock_mut()
+    {
+        if (detail::proxy_mutex::try_lock_write(m_mutex))
+            return make_optional_mut();
+        return {};
+    }
+
+    /// @brief Try to lock data for write access.
+    /// @return Handle on a copy of current version if available. Check before use.
+    OptionalHandleMut lock_mut(std::try_to_lock_t)
+    {
+        return try_lock_mut();
+    }
+
+    /// @brief Try to lock data for write access for given amount of time.
+    /// @param d Amount of time to try acquiring access. Returns if exceeded.
+    /// @return Handle on a copy of current version if available during given amount of time. Check before use.
+    template<typename Rep, typename Period>
+    OptionalHandleMut try_lock_mut_for(const std::chrono::duration<Rep, Period> &d)
+    {
+        if (detail::proxy_mutex::try_lock_write_for(m_mutex, d))
+            return make_optional_mut();
+        return {};
+    }
+
+    /// @brief Try to lock data for write access until given instant is reached.
+    /// @param tp Deadline for access to be granted. Returns if reached.
+    /// @return Handle on a copy of current version if available before deadline. Check before use.
+    template<typename Clock, typename Duration>
+    OptionalHandleMut try_lock_mut_until(const std::chrono::time_point<Clock, Duration> &tp)
+    {
+        if (detail::proxy_mutex::try_lock_write_until(m_mutex, tp))
+            return make_optional_mut();
+        return {};
+    }
+
+    /// @brief Wait for every replaced version of data to be reclaimed.
+    /// Calling thread must not hold any RcuMustex read handle, or this would never return.
+    void synchronize()
+    {
+        std::lock_guard<M> guard(m_mutex);
+        detail::Backoff backoff;
+        for (reclaim(); !m_retired.empty(); reclaim())
+            backoff.pause();
+    }
+
+private:
+    friend HandleMut;
+
+    std::atomic<data_t *> m_current;
+    M m_mutex;
+    /// @brief Replaced versions that may still be accessed by readers, guarded by writer mutex.
+    std::vector<Retired> m_retired;
+};
+
+} // namespace bcx
+
+#endif // #ifndef BCX_RCU_MUSTEX_HPP
@@ -0,0 +1,348 @@
+#ifndef BCX_SEQ_MUSTEX_HPP
+#define BCX_SEQ_MUSTEX_HPP
+
+#include "mustex.hpp"
+
+#include <atomic>
+#include <cstring>
+#include <type_traits>
+
+namespace bcx
+{
+
+// Forward declares
+template<typename T, class M>
+class SeqMustex;
+
+/// @brief Mutable access to SeqMustex data, mirroring MustexHandle.
+/// The handle works on a private copy of the data, published to readers when dropped.
+/// @tparam T Type of data to be accessed.
+/// @tparam M Type of mutex serializing writers.
+template<typename T, class M>
+class SeqMustexHandle
+{
+public:
+    // Only parent SeqMustex can instantiate this class.
+    template<class MT, class MM>
+    friend class SeqMustex;
+
+    /// @brief The type of contained value, exposed for convenience.
+    using data_t = typename std::remove_cv<T>::type;
+
+    SeqMustexHandle() = delete;
+    SeqMustexHandle(const SeqMustexHandle &) = delete;
+    SeqMustexHandle(SeqMustexHandle &&other)
+        : m_owner{other.m_owner}
+        , m_data(other.m_data)
+    {
+        other.m_owner = nullptr;
+    }
+
+    SeqMustexHandle &operator=(const SeqMustexHandle &other) = delete;
+    SeqMustexHandle &operator=(SeqMustexHandle &&other)
+    {
+        unlock();
+        m_owner = other.m_owner;
+        other.m_owner = nullptr;
+        m_data = other.m_data;
+        return *this;
+    }
+
+    ~SeqMustexHandle()
+    {
+        unlock();
+    }
+
+    T &operator*()
+    {
+        return m_data;
+    }
+
+    T *operator->()
+    {
+        return &m_data;
+    }
+
+private:
+    SeqMustex<data_t, M> *m_owner;
+    data_t m_data;
+
+    /// @brief Create handle on ALREADY ACQUIRED writer mutex.
+    SeqMustexHandle(SeqMustex<data_t, M> *owner, const data_t &data)
+        : m_owner{owner}
+        , m_data(data)
+    {
+    }
+
+    void unlock()
+    {
+        if (!m_owner)
+            return;
+        m_owner->store(m_data);
+        detail::proxy_mutex::unlock_write(m_owner->m_mutex);
+    }
+};
+
+/// @brief Read-only access to SeqMustex data, mirroring MustexHandle.
+/// The handle owns a consistent snapshot of the data, and does not hold any lock.
+/// @tparam T Type of data to be accessed.
+/// @tparam M Type of mutex serializing writers.
+template<typename T, class M>
+class SeqMustexHandle<const T, M>
+{
+public:
+    // Only parent SeqMustex can instantiate this class.
+    template<class MT, class MM>
+    friend class SeqMustex;
+
+    /// @brief The type of contained value, exposed for convenience.
+    using data_t = typename std::remove_cv<T>::type;
+
+    SeqMustexHandle() = delete;
+    SeqMustexHandle(const SeqMustexHandle &) = delete;
+    SeqMustexHandle(SeqMustexHandle &&other) = default;
+    SeqMustexHandle &operator=(const SeqMustexHandle &other) = delete;
+    SeqMustexHandle &operator=(SeqMustexHandle &&other) = default;
+    ~SeqMustexHandle() = default;
+
+    const T &operator*() const
+    {
+        return m_data;
+    }
+
+    const T *operator->() const
+    {
+        return &m_data;
+    }
+
+private:
+    data_t m_data;
+
+    explicit SeqMustexHandle(const data_t &data)
+        : m_data(data)
+    {
+    }
+};
+
+/// @brief Data-owning sequence lock, for small trivially copyable data.
+/// Readers copy the data out optimistically and retry if a writer published meanwhile, hence never
+/// write to shared memory and never block writers. Writers are serialized by a mutex, and publish
+/// their modifications when their handle is dropped.
+/// @tparam T The type of data to be shared among threads, must be trivially copyable and default
+/// constructible.
+/// @tparam M Type of mutex serializing writers.
+template<class T, class M = std::timed_mutex>
+class SeqMustex
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SeqMustex data must be trivially copyable");
+    static_assert(std::is_default_constructible<T>::value, "SeqMustex data must be default constructible");
+
+public:
+    /// @brief The type of contained value, exposed for convenience.
+    using data_t = typename std::remove_cv<T>::type;
+    /// @brief The type of mutex used, exposed for convenience.
+    using mutex_t = M;
+    /// @brief The type of handle used to access data.
+    using Handle = SeqMustexHandle<const data_t, M>;
+    /// @brief The type of handle used to access data mutably.
+    using HandleMut = SeqMustexHandle<data_t, M>;
+
+    template<typename... Args>
+    SeqMustex(Args &&...args)
+        : m_sequence{0}
+        , m_mutex{}
+    {
+        const data_t data(std::forward<Args>(args)...);
+        word_t words[WORDS] = {};
+        std::memcpy(words, &data, sizeof(data_t));
+        for (std::size_t i = 0; i < WORDS; ++i)
+            m_words[i].store(words[i], std::memory_order_relaxed);
+    }
+
+    SeqMustex(const SeqMustex &) = delete;
+    SeqMustex(SeqMustex &&other) = delete;
+    SeqMustex &operator=(const SeqMustex &other) = delete;
+    SeqMustex &operator=(SeqMustex &&other) = delete;
+
+    ~SeqMustex() = default;
+
+private:
+    using OptionalHandle = detail::Optional<Handle>;
+    using OptionalHandleMut = detail::Optional<HandleMut>;
+
+    /// @brief Storage unit of data, allowing readers to race with writers without undefined behavior.
+    using word_t = std::size_t;
+    static constexpr std::size_t WORDS = (sizeof(data_t) + sizeof(word_t) - 1) / sizeof(word_t);
+
+    /// @brief Make a single attempt at reading a consistent snapshot.
+    /// @return True for success, in which case `data` is filled.
+    bool try_load(data_t &data) const
+    {
+        const std::size_t sequence = m_sequence.load(std::memory_order_acquire);
+        if (sequence & 1)
+            return false;
+        word_t words[WORDS];
+        for (std::size_t i = 0; i < WORDS; ++i)
+            words[i] = m_words[i].load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_sequence.load(std::memory_order_relaxed) != sequence)
+            return false;
+        std::memcpy(&data, words, sizeof(data_t));
+        return true;
+    }
+
+    /// @brief Read data while writer mutex is held, no writer can be publishing.
+    data_t load_locked() const
+    {
+        word_t words[WORDS];
+        for (std::size_t i = 0; i < WORDS; ++i)
+            words[i] = m_words[i].load(std::memory_order_relaxed);
+        data_t data;
+        std::memcpy(&data, words, sizeof(data_t));
+        return data;
+    }
+
+    /// @brief Publish data, writer mutex must be held.
+    void store(const data_t &data)
+    {
+        word_t words[WORDS] = {};
+        std::memcpy(words, &data, sizeof(data_t));
+        const std::size_t sequence = m_sequence.load(std::memory_order_relaxed);
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (std::size_t i = 0; i < WORDS; ++i)
+            m_words[i].store(words[i], std::memory_order_relaxed);
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    static OptionalHandle make_optional(const data_t &data)
+    {
+        return Handle(data);
+    }
+
+    OptionalHandleMut make_optional_mut()
+    {
+        return HandleMut(this, load_locked());
+    }
+
+    template<typename Clock, typename Duration>
+    OptionalHandle try_lock_until_impl(const std::chrono::time_point<Clock, Duration> &tp) const
+    {
+        data_t data;
+        detail::Backoff backoff;
+        while (!try_load(data))
+        {
+            if (Clock::now() >= tp)
+                return {};
+            backoff.pause();
+        }
+        return make_optional(data);
+    }
+
+public:
+    /// @brief Read a consistent snapshot of data, retrying while writers are publishing.
+    /// @return Handle on a copy of owned data.
+    Handle lock() const
+    {
+        data_t data;
+        detail::Backoff backoff;
+        while (!try_load(data))
+            backoff.pause();
+        return Handle(data);
+    }
+
+    /// @brief Make a single attempt at reading a consistent snapshot of data.
+    /// @return Handle on a copy of owned data, unless a writer was publishing. Check before use.
+    OptionalHandle try_lock() const
+    {
+        data_t data;
+        if (!try_load(data))
+            return {};
+        return make_optional(data);
+    }
+
+    /// @brief Make a single attempt at reading a consistent snapshot of data.
+    /// @return Handle on a copy of owned data, unless a writer was publishing. Check before use.
+    OptionalHandle lock(std::try_to_lock_t) const
+    {
+        return try_lock();
+    }
+
+    /// @brief Try to read a consistent snapshot of data for given amount of time.
+    /// @param d Amount of time to try reading. Returns if exceeded.
+    /// @return Handle on a copy of owned data if read during given amount of time. Check before use.
+    template<typename Rep, typename Period>
+    OptionalHandle try_lock_for(const std::chrono::duration<Rep, Period> &d) const
+    {
+        return try_lock_until_impl(std::chrono::steady_clock::now() + d);
+    }
+
+    /// @brief Try to read a consistent snapshot of data until given instant is reached.
+    /// @param tp Deadline for reading. Returns if reached.
+    /// @return Handle on a copy of owned data if read before deadline. Check before use.
+    template<typename Clock, typename Duration>
+    OptionalHandle try_lock_until(const std::chrono::time_point<Clock, Duration> &tp) const
+    {
+        return try_lock_until_impl(tp);
+    }
+
+    /// @brief Lock data for write access. Readers are not blocked until handle is dropped.
+    /// @return Handle on a copy of owned data, published when dropped.
+    HandleMut lock_mut()
+    {
+        detail::proxy_mutex::lock_write(m_mutex);
+        return HandleMut(this, load_locked());
+    }
+
+    /// @brief Try to lock data for write access.
+    /// @return Handle on a copy of owned data if available. Check before use.
+    OptionalHandleMut try_lock_mut()
+    {
+        if (detail::proxy_mutex::try_lock_write(m_mutex))
+            return make_optional_mut();
+        return {};
+    }
+
+    /// @brief Try to lock data for write access.
+    /// @return Handle on a copy of owned data if available. Check before use.
+    OptionalHandleMut lock_mut(std::try_to_lock_t)
+    {
+        return try_lock_mut();
+    }
+
+    /// @brief Try to lock data for write access for given amount of time.
+    /// @param d Amount of time to try acquiring access. Returns if exceeded.
+    /// @return Handle on a copy of owned data if available during given amount of time. Check before use.
+    template<typename Rep, typename Period>
+    OptionalHandleMut try_lock_mut_for(const std::chrono::duration<Rep, Period> &d)
+    {
+        if (detail::proxy_mutex::try_lock_write_for(m_mutex, d))
+            return make_optional_mut();
+        return {};
+    }
+
+    /// @brief Try to lock data for write access until given instant is reached.
+    /// @param tp Deadline for access to be granted. Returns if reached.
+    /// @return Handle on a copy of owned data if available before deadline. Check before use.
+    template<typename Clock, typename Duration>
+    OptionalHandleMut try_lock_mut_until(const std::chrono::time_point<Clock, Duration> &tp)
+    {
+        if (detail::proxy_mutex::try_lock_write_until(m_mutex, tp))
+            return make_optional_mut();
+        return {};
+    }
+
+private:
+    friend HandleMut;
+
+    std::atomic<std::size_t> m_sequence;
+    std::atomic<word_t> m_words[WORDS];
+    M m_mutex;
+};
+
+template<class T, class M>
+constexpr std::size_t SeqMustex<T, M>::WORDS;
+
+} // namespace bcx
+
+#endif // #ifndef BCX_SEQ_MUSTEX_HPP
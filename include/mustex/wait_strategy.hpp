@@ -0,0 +1,134 @@
+#ifndef BCX_WAIT_STRATEGY_HPP
+#define BCX_WAIT_STRATEGY_HPP
+
+#include "mustex.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <thread>
+#include <utility>
+
+namespace bcx
+{
+
+/// @brief Wait strategy spinning with exponential backoff for a few attempts, then parking.
+struct SpinWait
+{
+    static bool wait(std::size_t attempt)
+    {
+        if (attempt >= MAX_ATTEMPTS)
+            return false;
+        for (std::size_t i = 0; i < (std::size_t(1) << attempt); ++i)
+            detail::cpu_relax();
+        return true;
+    }
+
+    static constexpr std::size_t MAX_ATTEMPTS = 8;
+};
+
+/// @brief Wait strategy yielding to the OS scheduler between attempts, never parking.
+struct YieldWait
+{
+    static bool wait(std::size_t)
+    {
+        std::this_thread::yield();
+        return true;
+    }
+};
+
+/// @brief Wait strategy parking right away, as the wrapped mutex does on its own.
+struct ParkWait
+{
+    static bool wait(std::size_t) { return false; }
+};
+
+/// @brief Wait strategy calling back the function set for calling thread between attempts, such as
+/// a task scheduler running another ready task, and parking once it returns false or if none is set.
+/// The callback runs on the waiting thread, which may hold other locks.
+struct CallbackWait
+{
+    /// @brief Set the callback of calling thread, empty to park right away.
+    /// @return Previous callback of calling thread.
+    static std::function<bool()> set_this_thread(std::function<bool()> callback)
+    {
+        std::swap(this_thread(), callback);
+        return callback;
+    }
+
+    static bool wait(std::size_t)
+    {
+        const std::function<bool()> &callback = this_thread();
+        return callback && callback();
+    }
+
+private:
+    static std::function<bool()> &this_thread()
+    {
+        static thread_local std::function<bool()> callback;
+        return callback;
+    }
+};
+
+namespace detail
+{
+/// @brief Retry given try lock for as long as wait strategy S lets calling thread wait between
+/// attempts, then block in given lock.
+template<class S, typename TryLock, typename Lock>
+void lock_with_strategy(TryLock try_lock, Lock lock)
+{
+    for (std::size_t attempt = 0; !try_lock(); ++attempt)
+    {
+        if (!S::wait(attempt))
+        {
+            lock();
+            return;
+        }
+    }
+}
+} // namespace detail
+
+/// @brief Mutex M whose blocking acquisitions consult wait strategy S while the mutex is contended.
+/// S provides `static bool wait(std::size_t attempt)`, called after each failed attempt at trying
+/// to acquire the mutex, which waits in its own way then returns true to try again, or false to
+/// block in M until acquired. SpinWait, YieldWait, ParkWait and CallbackWait are provided, the last
+/// one letting a task scheduler run other ready tasks on a worker waiting for a lock.
+/// Blocking paths of Mustex, bcx::lock_mut() and std::lock() go through lock(), lock_shared() and
+/// lock_upgrade(), hence all consult the strategy. Try and timed acquisitions, as well as upgrading
+/// which only waits for readers of this mutex, are left to M.
+/// Meets the same requirements as M, and can be used as `Mustex<T, WithWaitStrategy<M, S>>`.
+template<class M, class S>
+class WithWaitStrategy : public detail::MutexWrapper<M>
+{
+public:
+    using wait_strategy_t = S;
+
+    void lock()
+    {
+        detail::lock_with_strategy<S>(
+            [this] { return this->m_mutex.try_lock(); },
+            [this] { this->m_mutex.lock(); }
+        );
+    }
+
+    template<typename U = M>
+    auto lock_shared() -> decltype(std::declval<U &>().lock_shared())
+    {
+        detail::lock_with_strategy<S>(
+            [this] { return this->m_mutex.try_lock_shared(); },
+            [this] { this->m_mutex.lock_shared(); }
+        );
+    }
+
+    template<typename U = M>
+    auto lock_upgrade() -> decltype(std::declval<U &>().lock_upgrade())
+    {
+        detail::lock_with_strategy<S>(
+            [this] { return this->m_mutex.try_lock_upgrade(); },
+            [this] { this->m_mutex.lock_upgrade(); }
+        );
+    }
+};
+
+} // namespace bcx
+
+#endif // #ifndef BCX_WAIT_STRATEGY_HPP
@@ -0,0 +1,105 @@
+#if CATCH2_VERSION == 2
+#    include <catch2/catch.hpp>
+#else
+#    include <catch2/catch_test_macros.hpp>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mustex/adaptive_mutex.hpp>
+#include <thread>
+#include <vector>
+
+using namespace bcx;
+
+static_assert(detail::is_shared_timed_lockable<AdaptiveMutex>::value, "AdaptiveMutex must be SharedTimedLockable");
+static_assert(detail::is_timed_lockable<AdaptiveMutex>::value, "AdaptiveMutex must be TimedLockable");
+static_assert(sizeof(AdaptiveMutex) == 8, "AdaptiveMutex must stay compact");
+
+TEST_CASE("Adaptive mutex readers do not exclude each other", "[adaptive_mutex]")
+{
+    Mustex<int, AdaptiveMutex> m(42);
+    auto handle = m.lock();
+    auto future = std::async(
+        [&m]
+        {
+            auto handle = m.lock();
+            REQUIRE(*handle == 42);
+            REQUIRE(m.try_lock());
+            REQUIRE_FALSE(m.try_lock_mut());
+            REQUIRE_FALSE(m.try_lock_mut_for(std::chrono::milliseconds(10)));
+        }
+    );
+    future.wait();
+    REQUIRE(*handle == 42);
+}
+
+TEST_CASE("Adaptive mutex parked waiters are woken up", "[adaptive_mutex]")
+{
+    Mustex<int, AdaptiveMutex> m(42);
+    std::atomic<bool> started{false};
+
+    auto future = std::async(
+        [&m, &started]
+        {
+            auto handle = m.lock_mut();
+            started = true;
+            *handle = 8;
+            // Long enough for waiters to give up spinning.
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    );
+    while (!started)
+        ;
+
+    REQUIRE_FALSE(m.try_lock());
+    REQUIRE_FALSE(m.try_lock_for(std::chrono::milliseconds(10)));
+    auto reader = std::async([&m] { return *m.lock(); });
+    auto writer = std::async(std::launch::async, [&m] { *m.lock_mut() += 1; });
+    auto opt_handle = m.try_lock_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(1000));
+    REQUIRE(opt_handle);
+    REQUIRE(**opt_handle >= 8);
+    opt_handle = {};
+    writer.wait();
+    REQUIRE(reader.get() >= 8);
+    REQUIRE(*m.lock() == 9);
+    future.wait();
+}
+
+TEST_CASE("Adaptive mutex under contention", "[adaptive_mutex]")
+{
+    Mustex<std::vector<int>, AdaptiveMutex> m;
+    std::vector<std::future<void>> futures;
+    std::atomic<bool> consistent{true};
+    for (int t = 0; t < 4; ++t)
+    {
+        futures.push_back(std::async(
+            std::launch::async,
+            [&m, &consistent, t]
+            {
+                for (int i = 0; i < 500; ++i)
+                {
+                    if (i % 2 == 0)
+                    {
+                        auto handle = m.lock_mut();
+                        handle->push_back(t);
+                        std::this_thread::yield();
+                        handle->push_back(t);
+                    }
+                    else
+                    {
+                        auto handle = m.lock();
+                        for (std::size_t j = 0; j < handle->size(); j += 2)
+                            if ((*handle)[j] != (*handle)[j + 1])
+                                consistent = false;
+                    }
+                }
+            }
+        ));
+    }
+    for (auto &future : futures)
+        future.wait();
+    REQUIRE(consistent);
+    REQUIRE(m.lock()->size() == 2000);
+}
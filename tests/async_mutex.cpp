@@ -0,0 +1,206 @@
+#if CATCH2_VERSION == 2
+#    include <catch2/catch.hpp>
+#else
+#    include <catch2/catch_test_macros.hpp>
+#endif
+
+#include <mustex/async_mutex.hpp>
+
+static_assert(bcx::detail::is_shared_lockable<bcx::AsyncMutex>::value, "AsyncMutex must be SharedLockable");
+
+#ifdef _MUSTEX_HAS_COROUTINES
+#    include <atomic>
+#    include <coroutine>
+#    include <deque>
+#    include <exception>
+#    include <future>
+#    include <mutex>
+#    include <thread>
+#    include <vector>
+
+using namespace bcx;
+
+namespace
+{
+/// @brief Coroutine started right away, and never awaited.
+struct Task
+{
+    struct promise_type
+    {
+        Task get_return_object() { return {}; }
+        std::suspend_never initial_suspend() { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+/// @brief Executor queuing coroutines up, until resumed by run().
+class QueueExecutor
+{
+public:
+    void operator()(std::coroutine_handle<> coroutine)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_queue.push_back(coroutine);
+    }
+
+    /// @brief Resume queued coroutines.
+    /// @return Number of resumed coroutines.
+    std::size_t run()
+    {
+        std::size_t resumed = 0;
+        for (;;)
+        {
+            std::coroutine_handle<> coroutine;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_queue.empty())
+                    return resumed;
+                coroutine = m_queue.front();
+                m_queue.pop_front();
+            }
+            coroutine.resume();
+            ++resumed;
+        }
+    }
+
+private:
+    std::mutex m_mutex;
+    std::deque<std::coroutine_handle<>> m_queue;
+};
+
+/// @brief Executor handing coroutines to a QueueExecutor.
+struct QueueExecutorRef
+{
+    QueueExecutor *executor;
+
+    void operator()(std::coroutine_handle<> coroutine) const { (*executor)(coroutine); }
+};
+
+Task increment(Mustex<int, AsyncMutex> &m, bool &done)
+{
+    auto handle = co_await m.lock_mut_async();
+    ++*handle;
+    done = true;
+}
+
+Task read(const Mustex<int, AsyncMutex> &m, int &value)
+{
+    auto handle = co_await m.lock_async();
+    value = *handle;
+}
+} // namespace
+
+TEST_CASE("Async lock without contention does not suspend", "[async_mutex]")
+{
+    Mustex<int, AsyncMutex> m(1);
+    bool done = false;
+    int value = 0;
+
+    increment(m, done);
+    REQUIRE(done);
+    read(m, value);
+    REQUIRE(value == 2);
+    REQUIRE(m.try_lock_mut());
+}
+
+TEST_CASE("Async lock resumes coroutine once handed the mutex", "[async_mutex]")
+{
+    Mustex<int, AsyncMutex> m(1);
+    bool done = false;
+    int value = 0;
+
+    {
+        auto handle = m.lock_mut();
+        increment(m, done);
+        read(m, value);
+        REQUIRE_FALSE(done);
+        *handle = 10;
+    }
+    // Resumed inline by the unlocking thread, the writer first.
+    REQUIRE(done);
+    REQUIRE(value == 11);
+}
+
+TEST_CASE("Async lock resumes coroutine with given executor", "[async_mutex]")
+{
+    Mustex<int, AsyncMutex> m(1);
+    QueueExecutor executor;
+    std::vector<int> values(3, 0);
+
+    auto reader = [&m, &executor](int &value) -> Task
+    {
+        auto handle = co_await m.lock_async(QueueExecutorRef{&executor});
+        value = *handle;
+    };
+    {
+        auto handle = m.lock_mut();
+        for (int &value : values)
+            reader(value);
+        *handle = 5;
+    }
+    REQUIRE(values == std::vector<int>{0, 0, 0});
+    // Readers are handed the mutex together, writers wait for all of them.
+    REQUIRE_FALSE(m.try_lock_mut());
+    REQUIRE(executor.run() == 3);
+    REQUIRE(values == std::vector<int>{5, 5, 5});
+    REQUIRE(m.try_lock_mut());
+}
+
+TEST_CASE("Async lock does not let newcomers overtake queued writers", "[async_mutex]")
+{
+    Mustex<int, AsyncMutex> m(1);
+    bool done = false;
+    int value = 0;
+
+    {
+        auto handle = m.lock();
+        increment(m, done);
+        REQUIRE_FALSE(done);
+        REQUIRE_FALSE(m.try_lock());
+        read(m, value);
+        REQUIRE(value == 0);
+    }
+    REQUIRE(done);
+    REQUIRE(value == 2);
+}
+
+TEST_CASE("Async lock serves many coroutines from few threads", "[async_mutex]")
+{
+    Mustex<int, AsyncMutex> m(0);
+    QueueExecutor executor;
+    std::atomic<int> finished{0};
+    constexpr int COROUTINES = 2000;
+
+    auto task = [&m, &executor, &finished]() -> Task
+    {
+        for (int i = 0; i < 10; ++i)
+        {
+            auto handle = co_await m.lock_mut_async(QueueExecutorRef{&executor});
+            ++*handle;
+        }
+        ++finished;
+    };
+
+    auto worker = [&]
+    {
+        while (finished < COROUTINES)
+            if (!executor.run())
+                std::this_thread::yield();
+    };
+    {
+        auto handle = m.lock_mut();
+        for (int i = 0; i < COROUTINES; ++i)
+            task();
+    }
+    auto future1 = std::async(std::launch::async, worker);
+    auto future2 = std::async(std::launch::async, worker);
+    // Synchronous lockers queue up along with coroutines.
+    for (int i = 0; i < 100; ++i)
+        ++*m.lock_mut();
+    future1.wait();
+    future2.wait();
+    REQUIRE(*m.lock() == COROUTINES * 10 + 100);
+}
+#endif // #ifdef _MUSTEX_HAS_COROUTINES
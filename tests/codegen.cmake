@@ -0,0 +1,47 @@
+# Compile codegen.cpp to assembly and check that mustex_increment() and raw_increment() compile to
+# the same instructions.
+# Expects COMPILER, STANDARD, INCLUDE_DIR, SOURCE and OUTPUT to be defined.
+
+execute_process(
+    COMMAND ${COMPILER} -std=c++${STANDARD} -O2 -S -I${INCLUDE_DIR} -o ${OUTPUT} ${SOURCE}
+    RESULT_VARIABLE result
+    ERROR_VARIABLE error
+)
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Could not compile ${SOURCE}:\n${error}")
+endif()
+
+file(STRINGS ${OUTPUT} lines)
+
+# Instructions of function NAME, directives dropped and labels renamed so that functions compare.
+function(extract_instructions NAME OUT)
+    set(instructions "")
+    set(inside FALSE)
+    foreach(line IN LISTS lines)
+        if(line MATCHES "^${NAME}:")
+            set(inside TRUE)
+        elseif(inside)
+            if(line MATCHES "^[ \t]*\\.cfi_endproc" OR line MATCHES "^[ \t]*\\.size[ \t]")
+                break()
+            endif()
+            if(NOT line MATCHES "^[ \t]*\\.[a-z_0-9]+([ \t]|$)")
+                string(REGEX REPLACE "\\.L[A-Za-z_]*[0-9]+" ".L" line "${line}")
+                string(REPLACE "${NAME}" "FUNCTION" line "${line}")
+                list(APPEND instructions "${line}")
+            endif()
+        endif()
+    endforeach()
+    set(${OUT} "${instructions}" PARENT_SCOPE)
+endfunction()
+
+extract_instructions(mustex_increment mustex)
+extract_instructions(raw_increment raw)
+
+if(NOT mustex)
+    message(FATAL_ERROR "Could not find mustex_increment in ${OUTPUT}")
+endif()
+if(NOT mustex STREQUAL raw)
+    string(REPLACE ";" "\n" mustex "${mustex}")
+    string(REPLACE ";" "\n" raw "${raw}")
+    message(FATAL_ERROR "Mustex::lock_mut() compiles to:\n${mustex}\n\nstd::unique_lock compiles to:\n${raw}")
+endif()
@@ -0,0 +1,22 @@
+// Compiled to assembly by codegen.cmake, which checks that both functions compile to the same
+// instructions, that is that a Mustex costs nothing over a mutex stored next to its data.
+
+#include <mustex/mustex.hpp>
+#include <mutex>
+
+struct RawMustex
+{
+    int data;
+    std::mutex mutex;
+};
+
+extern "C" void mustex_increment(bcx::Mustex<int, std::mutex> &m)
+{
+    ++*m.lock_mut();
+}
+
+extern "C" void raw_increment(RawMustex &m)
+{
+    std::unique_lock<std::mutex> lock(m.mutex);
+    ++m.data;
+}
@@ -0,0 +1,113 @@
+#if CATCH2_VERSION == 2
+#    include <catch2/catch.hpp>
+#else
+#    include <catch2/catch_test_macros.hpp>
+#endif
+
+#include <chrono>
+#include <future>
+#include <mustex/cohort_mutex.hpp>
+#include <thread>
+#include <vector>
+
+using namespace bcx;
+
+static_assert(detail::is_timed_lockable<CohortMutex>::value, "CohortMutex must be TimedLockable");
+
+namespace
+{
+/// @brief Lock given mutex from a thread simulated on given node, and record the node once locked.
+std::future<void> lock_from_node(CohortMutex &mutex, std::vector<std::size_t> &order, std::size_t node)
+{
+    return std::async(
+        std::launch::async,
+        [&mutex, &order, node]
+        {
+            CohortMutex::simulate_this_thread_node(node);
+            std::lock_guard<CohortMutex> lock(mutex);
+            order.push_back(node);
+        }
+    );
+}
+} // namespace
+
+TEST_CASE("Cohort mutex on detected topology", "[cohort_mutex]")
+{
+    REQUIRE(detail::NumaTopology::instance().nodes() >= 1);
+    Mustex<int, CohortMutex> m(42);
+    auto handle = m.lock_mut();
+    auto future = std::async(
+        std::launch::async,
+        [&m]
+        {
+            REQUIRE_FALSE(m.try_lock());
+            REQUIRE_FALSE(m.try_lock_mut_for(std::chrono::milliseconds(10)));
+        }
+    );
+    future.wait();
+    *handle = 8;
+}
+
+TEST_CASE("Cohort mutex is passed on within a node first", "[cohort_mutex]")
+{
+    CohortMutex mutex(2);
+    std::vector<std::size_t> order;
+    std::vector<std::future<void>> futures;
+    {
+        CohortMutex::simulate_this_thread_node(0);
+        std::lock_guard<CohortMutex> lock(mutex);
+        futures.push_back(lock_from_node(mutex, order, 1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        futures.push_back(lock_from_node(mutex, order, 0));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    for (auto &future : futures)
+        future.wait();
+    REQUIRE(order == std::vector<std::size_t>{0, 1});
+}
+
+TEST_CASE("Cohort mutex bounds handoffs within a node", "[cohort_mutex]")
+{
+    CohortMutex mutex(2, 0);
+    std::vector<std::size_t> order;
+    std::vector<std::future<void>> futures;
+    {
+        CohortMutex::simulate_this_thread_node(0);
+        std::lock_guard<CohortMutex> lock(mutex);
+        futures.push_back(lock_from_node(mutex, order, 1));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        futures.push_back(lock_from_node(mutex, order, 0));
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+    for (auto &future : futures)
+        future.wait();
+    REQUIRE(order == std::vector<std::size_t>{1, 0});
+}
+
+TEST_CASE("Cohort mutex under contention across simulated nodes", "[cohort_mutex]")
+{
+    CohortMutex mutex(2, 4);
+    int counter = 0;
+    std::vector<std::future<void>> futures;
+    for (std::size_t t = 0; t < 4; ++t)
+    {
+        futures.push_back(std::async(
+            std::launch::async,
+            [&mutex, &counter, t]
+            {
+                CohortMutex::simulate_this_thread_node(t % 2);
+                for (int i = 0; i < 1000; ++i)
+                {
+                    std::lock_guard<CohortMutex> lock(mutex);
+                    const int value = counter;
+                    if (i % 8 == 0)
+                        std::this_thread::yield();
+                    counter = value + 1;
+                }
+            }
+        ));
+    }
+    for (auto &future : futures)
+        future.wait();
+    REQUIRE(counter == 4000);
+}
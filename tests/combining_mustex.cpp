@@ -0,0 +1,174 @@
+#if CATCH2_VERSION == 2
+#    include <catch2/catch.hpp>
+#else
+#    include <catch2/catch_test_macros.hpp>
+#endif
+
+#include <atomic>
+#include <future>
+#include <memory>
+#include <mustex/combining_mustex.hpp>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace bcx;
+
+TEST_CASE("Combining Mustex applies operations and returns their result", "[combining_mustex]")
+{
+    CombiningMustex<std::vector<int>> m(3, 1);
+
+    m.apply([](std::vector<int> &v) { v.push_back(2); });
+    REQUIRE(m.apply([](std::vector<int> &v) { return v.size(); }) == 4);
+    // Results are returned by value.
+    std::unique_ptr<int> value = m.apply([](std::vector<int> &v) { return std::unique_ptr<int>(new int(v.back())); });
+    REQUIRE(*value == 2);
+    REQUIRE(m.lock()->size() == 4);
+    REQUIRE(m.try_lock_mut());
+}
+
+TEST_CASE("Combining Mustex rethrows exceptions of operations", "[combining_mustex]")
+{
+    CombiningMustex<int> m(1);
+
+    REQUIRE_THROWS_AS(
+        m.apply(
+            [](int &value)
+            {
+                ++value;
+                throw std::runtime_error("failed");
+            }
+        ),
+        std::runtime_error
+    );
+    REQUIRE(*m.lock() == 2);
+    REQUIRE(m.try_lock_mut());
+}
+
+TEST_CASE("Combining Mustex applies operations published while locked", "[combining_mustex]")
+{
+    CombiningMustex<std::string> m;
+    std::vector<std::future<std::size_t>> futures;
+
+    {
+        auto handle = m.lock_mut();
+        for (char c = 'a'; c < 'e'; ++c)
+            futures.push_back(std::async(
+                std::launch::async,
+                [&m, c]
+                {
+                    return m.apply(
+                        [c](std::string &s)
+                        {
+                            s += c;
+                            return s.size();
+                        }
+                    );
+                }
+            ));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        *handle = "x";
+    }
+    std::vector<bool> sizes(5, false);
+    for (std::future<std::size_t> &future : futures)
+        sizes[future.get() - 1] = true;
+    REQUIRE(sizes == std::vector<bool>{false, true, true, true, true});
+    REQUIRE(m.lock()->size() == 5);
+}
+
+namespace
+{
+/// @brief Number of times a CountingMutex was acquired.
+std::atomic<int> acquisitions{0};
+
+class CountingMutex
+{
+public:
+    void lock()
+    {
+        m_mutex.lock();
+        ++acquisitions;
+    }
+
+    bool try_lock()
+    {
+        if (!m_mutex.try_lock())
+            return false;
+        ++acquisitions;
+        return true;
+    }
+
+    void unlock() { m_mutex.unlock(); }
+
+private:
+    std::mutex m_mutex;
+};
+} // namespace
+
+TEST_CASE("Combining Mustex applies operations of several publishers per acquisition", "[combining_mustex]")
+{
+    CombiningMustex<int, CountingMutex> m(0);
+    const int publishers = 4;
+    std::vector<std::future<int>> futures;
+
+    acquisitions = 0;
+    {
+        auto handle = m.lock_mut();
+        for (int p = 0; p < publishers; ++p)
+            futures.push_back(std::async(
+                std::launch::async,
+                [&m]
+                {
+                    // Acquisition the operation was applied under.
+                    return m.apply(
+                        [](int &value)
+                        {
+                            ++value;
+                            return acquisitions.load();
+                        }
+                    );
+                }
+            ));
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    std::vector<int> served(publishers + 2, 0);
+    for (std::future<int> &future : futures)
+        ++served[static_cast<std::size_t>(future.get())];
+    // All operations were published before the handle was dropped, the first acquisition then
+    // applies them all, sparing the other publishers an acquisition.
+    REQUIRE(served[2] == publishers);
+    REQUIRE(acquisitions < 1 + publishers);
+    REQUIRE(*m.lock() == publishers);
+}
+
+TEST_CASE("Combining Mustex serializes operations from many threads", "[combining_mustex]")
+{
+    CombiningMustex<std::vector<int>> m;
+    const std::size_t threads = 2 * detail::COMBINING_SLOTS;
+    std::vector<std::future<void>> futures;
+
+    for (std::size_t t = 0; t < threads; ++t)
+        futures.push_back(std::async(
+            std::launch::async,
+            [&m, t]
+            {
+                for (int i = 0; i < 1000; ++i)
+                {
+                    if (i % 100 == 0)
+                        m.lock_mut()->push_back(static_cast<int>(t));
+                    else
+                        m.apply([t](std::vector<int> &v) { v.push_back(static_cast<int>(t)); });
+                }
+            }
+        ));
+    for (std::future<void> &future : futures)
+        future.wait();
+    auto handle = m.lock();
+    REQUIRE(handle->size() == threads * 1000);
+    std::vector<int> counts(threads, 0);
+    for (int t : *handle)
+        ++counts[static_cast<std::size_t>(t)];
+    REQUIRE(counts == std::vector<int>(threads, 1000));
+}
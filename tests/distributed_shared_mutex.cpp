@@ -0,0 +1,109 @@
+#if CATCH2_VERSION == 2
+#    include <catch2/catch.hpp>
+#else
+#    include <catch2/catch_test_macros.hpp>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mustex/distributed_shared_mutex.hpp>
+#include <thread>
+#include <vector>
+
+using namespace bcx;
+
+static_assert(detail::is_shared_timed_lockable<DistributedSharedMutex>::value, "DistributedSharedMutex must be SharedTimedLockable");
+static_assert(detail::is_timed_lockable<DistributedSharedMutex>::value, "DistributedSharedMutex must be TimedLockable");
+
+TEST_CASE("Distributed shared mutex readers do not exclude each other", "[distributed_shared_mutex]")
+{
+    Mustex<int, DistributedSharedMutex> m(42);
+    auto handle = m.lock();
+    auto future = std::async(
+        [&m]
+        {
+            auto handle = m.lock();
+            REQUIRE(*handle == 42);
+            REQUIRE(m.try_lock());
+            REQUIRE_FALSE(m.try_lock_mut());
+        }
+    );
+    future.wait();
+    REQUIRE(*handle == 42);
+}
+
+TEST_CASE("Distributed shared mutex writer excludes readers", "[distributed_shared_mutex]")
+{
+    Mustex<int, DistributedSharedMutex> m(42);
+    std::atomic<bool> started{false};
+
+    auto future = std::async(
+        [&m, &started]
+        {
+            auto handle = m.lock_mut();
+            started = true;
+            *handle = 8;
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    );
+    while (!started)
+        ;
+
+    REQUIRE_FALSE(m.try_lock());
+    REQUIRE_FALSE(m.try_lock_for(std::chrono::milliseconds(10)));
+    REQUIRE_FALSE(m.try_lock_mut_for(std::chrono::milliseconds(10)));
+    auto opt_handle = m.try_lock_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(1000));
+    REQUIRE(opt_handle);
+    REQUIRE(**opt_handle == 8);
+    future.wait();
+}
+
+TEST_CASE("Distributed shared mutex with a single slot", "[distributed_shared_mutex]")
+{
+    DistributedSharedMutex mutex(1);
+    mutex.lock_shared();
+    REQUIRE(mutex.try_lock_shared());
+    REQUIRE_FALSE(mutex.try_lock());
+    mutex.unlock_shared();
+    mutex.unlock_shared();
+    REQUIRE(mutex.try_lock());
+    REQUIRE_FALSE(mutex.try_lock_shared());
+    mutex.unlock();
+}
+
+TEST_CASE("Distributed shared mutex under contention", "[distributed_shared_mutex]")
+{
+    Mustex<std::vector<int>, DistributedSharedMutex> m;
+    std::vector<std::future<void>> futures;
+    std::atomic<bool> consistent{true};
+    for (int t = 0; t < 4; ++t)
+    {
+        futures.push_back(std::async(
+            std::launch::async,
+            [&m, &consistent, t]
+            {
+                for (int i = 0; i < 500; ++i)
+                {
+                    if (i % 5 == 0)
+                    {
+                        auto handle = m.lock_mut();
+                        handle->push_back(t);
+                        handle->push_back(t);
+                    }
+                    else
+                    {
+                        auto handle = m.lock();
+                        for (std::size_t j = 0; j < handle->size(); j += 2)
+                            if ((*handle)[j] != (*handle)[j + 1])
+                                consistent = false;
+                    }
+                }
+            }
+        ));
+    }
+    for (auto &future : futures)
+        future.wait();
+    REQUIRE(consistent);
+    REQUIRE(m.lock()->size() == 800);
+}
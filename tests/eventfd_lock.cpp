@@ -0,0 +1,136 @@
+#if CATCH2_VERSION == 2
+#    include <catch2/catch.hpp>
+#else
+#    include <catch2/catch_test_macros.hpp>
+#endif
+
+#include <mustex/eventfd_lock.hpp>
+
+#ifdef _MUSTEX_HAS_EVENTFD
+#    include <sys/epoll.h>
+#    include <unistd.h>
+#    include <chrono>
+#    include <future>
+#    include <memory>
+#    include <thread>
+
+using namespace bcx;
+
+namespace
+{
+/// @brief Epoll instance watching given descriptors for readability.
+class Epoll
+{
+public:
+    Epoll()
+        : m_fd(epoll_create1(EPOLL_CLOEXEC))
+    {
+    }
+
+    ~Epoll()
+    {
+        close(m_fd);
+    }
+
+    void add(int fd)
+    {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.fd = fd;
+        epoll_ctl(m_fd, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    /// @return Descriptor that became readable within given time, -1 if none.
+    int wait(int timeout_ms)
+    {
+        epoll_event event{};
+        return epoll_wait(m_fd, &event, 1, timeout_ms) == 1 ? event.data.fd : -1;
+    }
+
+private:
+    const int m_fd;
+};
+} // namespace
+
+TEST_CASE("Eventfd lock is readable right away without contention", "[eventfd_lock]")
+{
+    Mustex<int, AsyncMutex> m(1);
+    Epoll epoll;
+
+    EventfdLock<Mustex<int, AsyncMutex>> pending(m);
+    epoll.add(pending.fd());
+    REQUIRE(epoll.wait(0) == pending.fd());
+    auto handle = pending.take();
+    REQUIRE(handle);
+    **handle = 2;
+    REQUIRE_FALSE(pending.take());
+    REQUIRE_FALSE(m.try_lock());
+    handle.reset();
+    REQUIRE(*m.lock() == 2);
+}
+
+TEST_CASE("Eventfd lock is readable once the mutex is handed over", "[eventfd_lock]")
+{
+    Mustex<int, AsyncMutex> m(1);
+    Epoll epoll;
+    auto handle = m.try_lock_mut();
+    REQUIRE(handle);
+
+    EventfdLock<Mustex<int, AsyncMutex>> writer(m);
+    EventfdLock<const Mustex<int, AsyncMutex>> reader(m);
+    epoll.add(writer.fd());
+    epoll.add(reader.fd());
+    REQUIRE(epoll.wait(0) == -1);
+    REQUIRE_FALSE(writer.take());
+
+    auto unlocker = std::async(
+        std::launch::async,
+        [&handle]
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            **handle = 10;
+            handle.reset();
+        }
+    );
+    REQUIRE(epoll.wait(10000) == writer.fd());
+    unlocker.wait();
+    REQUIRE_FALSE(reader.take());
+    {
+        auto writer_handle = writer.take();
+        REQUIRE(writer_handle);
+        ++**writer_handle;
+    }
+    REQUIRE(epoll.wait(0) == reader.fd());
+    auto reader_handle = reader.take();
+    REQUIRE(reader_handle);
+    REQUIRE(**reader_handle == 11);
+    REQUIRE(m.try_lock());
+}
+
+TEST_CASE("Eventfd lock destroyed before taking the handle gives up the lock", "[eventfd_lock]")
+{
+    Mustex<int, AsyncMutex> m(1);
+
+    {
+        auto handle = m.lock();
+        std::unique_ptr<EventfdLock<Mustex<int, AsyncMutex>>> writer(new EventfdLock<Mustex<int, AsyncMutex>>(m));
+        EventfdLock<const Mustex<int, AsyncMutex>> reader(m);
+        {
+            EventfdLock<Mustex<int, AsyncMutex>> cancelled(m);
+        }
+        REQUIRE_FALSE(reader.take());
+        // Readers queued up behind a cancelled writer join the current ones.
+        writer.reset();
+        auto reader_handle = reader.take();
+        REQUIRE(reader_handle);
+        REQUIRE(**reader_handle == 1);
+        REQUIRE_FALSE(m.try_lock_mut());
+    }
+    REQUIRE(m.try_lock_mut());
+    {
+        // Handed over but never taken.
+        EventfdLock<Mustex<int, AsyncMutex>> writer(m);
+    }
+    REQUIRE(m.try_lock_mut());
+}
+#endif // #ifdef _MUSTEX_HAS_EVENTFD
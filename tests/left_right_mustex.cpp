@@ -0,0 +1,181 @@
+#if CATCH2_VERSION == 2
+#    include <catch2/catch.hpp>
+#else
+#    include <catch2/catch_test_macros.hpp>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <mustex/left_right_mustex.hpp>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace bcx;
+
+TEST_CASE("Lock left-right mustex", "[left_right_mustex]")
+{
+    LeftRightMustex<int> m(42);
+    auto handle = m.lock();
+    REQUIRE(*handle == 42);
+}
+
+TEST_CASE("Lock left-right mustex mutably", "[left_right_mustex]")
+{
+    LeftRightMustex<std::vector<int>> m;
+    {
+        auto handle = m.lock_mut();
+        handle.apply([](std::vector<int> &v) { v.push_back(1); });
+        handle.apply([](std::vector<int> &v) { v.push_back(2); });
+        REQUIRE(handle->size() == 2);
+        // Readers see mutations once the handle is dropped.
+        REQUIRE(m.lock()->empty());
+    }
+    REQUIRE(*m.lock() == std::vector<int>{1, 2});
+
+    // Both replicas received the mutations.
+    m.modify([](std::vector<int> &v) { v.push_back(3); });
+    REQUIRE(*m.lock() == std::vector<int>{1, 2, 3});
+    m.modify([](std::vector<int> &v) { v.push_back(4); });
+    REQUIRE(*m.lock() == std::vector<int>{1, 2, 3, 4});
+}
+
+/// @brief Move-only mutation appending its value.
+struct PushUnique
+{
+    std::unique_ptr<int> value;
+
+    void operator()(std::vector<int> &v) const { v.push_back(*value); }
+};
+
+TEST_CASE("Left-right mustex replays move-only mutations, not throwing ones", "[left_right_mustex]")
+{
+    LeftRightMustex<std::vector<int>> m;
+    {
+        auto handle = m.lock_mut();
+        handle.apply(PushUnique{std::unique_ptr<int>(new int(1))});
+        REQUIRE_THROWS_AS(
+            handle.apply([](std::vector<int> &) { throw std::runtime_error("failed"); }),
+            std::runtime_error
+        );
+        handle.apply(PushUnique{std::unique_ptr<int>(new int(2))});
+    }
+    REQUIRE(*m.lock() == std::vector<int>{1, 2});
+
+    // Switch replicas once more, so that readers see the one mutations were replayed on.
+    m.modify(PushUnique{std::unique_ptr<int>(new int(3))});
+    REQUIRE(*m.lock() == std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("Left-right mustex replicas agree after mutation throws midway", "[left_right_mustex]")
+{
+    LeftRightMustex<std::vector<int>> m;
+    m.modify([](std::vector<int> &v) { v.push_back(1); });
+    {
+        auto handle = m.lock_mut();
+        // Throws once part of its work is done, leaving the data unchanged as required.
+        REQUIRE_THROWS_AS(
+            handle.apply(
+                [](std::vector<int> &v)
+                {
+                    std::vector<int> updated(v);
+                    updated.push_back(2);
+                    if (updated.size() > 1)
+                        throw std::runtime_error("failed");
+                    v.swap(updated);
+                }
+            ),
+            std::runtime_error
+        );
+        handle.apply([](std::vector<int> &v) { v.push_back(3); });
+    }
+    REQUIRE(*m.lock() == std::vector<int>{1, 3});
+
+    // Switch replicas, both must hold the same data.
+    m.modify([](std::vector<int> &) {});
+    REQUIRE(*m.lock() == std::vector<int>{1, 3});
+    m.modify([](std::vector<int> &) {});
+    REQUIRE(*m.lock() == std::vector<int>{1, 3});
+}
+
+TEST_CASE("Left-right mustex writer waits for readers of replayed replica", "[left_right_mustex]")
+{
+    LeftRightMustex<int> m(42);
+
+    std::atomic<bool> started{false};
+    auto future = std::async(
+        [&m, &started]
+        {
+            auto handle = m.lock();
+            started = true;
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+            REQUIRE(*handle == 42);
+        }
+    );
+    while (!started)
+        ;
+
+    auto tic = std::chrono::high_resolution_clock::now();
+    m.modify([](int &value) { value = 8; });
+    auto tac = std::chrono::high_resolution_clock::now();
+
+    REQUIRE(*m.lock() == 8);
+    REQUIRE(tac - tic >= std::chrono::milliseconds(50));
+    future.wait();
+}
+
+TEST_CASE("Try lock left-right mustex mutably", "[left_right_mustex]")
+{
+    LeftRightMustex<int> m(42);
+    std::atomic<bool> started{false};
+
+    auto future = std::async(
+        [&m, &started]
+        {
+            auto opt_handle = m.try_lock_mut();
+            started = true;
+            REQUIRE(opt_handle);
+            opt_handle->apply([](int &value) { value = 45; });
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    );
+
+    while (!started)
+        ;
+
+    REQUIRE(m.try_lock());
+    REQUIRE_FALSE(m.lock_mut(std::try_to_lock));
+    REQUIRE_FALSE(m.try_lock_mut_for(std::chrono::milliseconds(10)));
+    auto opt_handle = m.try_lock_mut_for(std::chrono::milliseconds(1000));
+    REQUIRE(opt_handle);
+    REQUIRE(**opt_handle == 45);
+    future.wait();
+}
+
+TEST_CASE("Left-right mustex readers race with writers", "[left_right_mustex]")
+{
+    LeftRightMustex<std::vector<int>> m;
+    std::atomic<bool> running{true};
+
+    auto writer = std::async(
+        [&m, &running]
+        {
+            for (int i = 0; i < 1000; ++i)
+                m.modify([i](std::vector<int> &v) { v.push_back(i); });
+            running = false;
+        }
+    );
+
+    bool consistent = true;
+    while (running)
+    {
+        auto handle = m.lock();
+        for (std::size_t i = 0; i < handle->size(); ++i)
+            consistent = consistent && (*handle)[i] == static_cast<int>(i);
+    }
+    writer.wait();
+    REQUIRE(consistent);
+    REQUIRE(m.lock()->size() == 1000);
+}
@@ -0,0 +1,127 @@
+#if CATCH2_VERSION == 2
+#    include <catch2/catch.hpp>
+#else
+#    include <catch2/catch_test_macros.hpp>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <mustex/mcs_mutex.hpp>
+#include <thread>
+#include <vector>
+
+using namespace bcx;
+
+static_assert(detail::is_timed_lockable<McsMutex>::value, "McsMutex must be TimedLockable");
+static_assert(detail::is_shared_timed_lockable<McsSharedMutex>::value, "McsSharedMutex must be SharedTimedLockable");
+
+TEST_CASE("MCS mutex hands over in arrival order", "[mcs_mutex]")
+{
+    Mustex<std::vector<int>, McsMutex> m;
+    std::vector<std::future<void>> futures;
+    {
+        auto handle = m.lock_mut();
+        for (int t = 0; t < 4; ++t)
+        {
+            futures.push_back(std::async(std::launch::async, [&m, t] { m.lock_mut()->push_back(t); }));
+            // Let the thread queue up before starting the next one.
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+        REQUIRE_FALSE(m.try_lock_mut());
+        REQUIRE_FALSE(m.try_lock_for(std::chrono::milliseconds(10)));
+    }
+    for (auto &future : futures)
+        future.wait();
+    REQUIRE(*m.lock() == std::vector<int>{0, 1, 2, 3});
+}
+
+TEST_CASE("MCS mutex with deadlock avoidance", "[mcs_mutex]")
+{
+    Mustex<int, McsMutex> m1(0);
+    Mustex<int, McsMutex> m2(0);
+    auto worker = [](Mustex<int, McsMutex> &first, Mustex<int, McsMutex> &second)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            auto handles = lock_mut(first, second);
+            ++*std::get<0>(handles);
+            ++*std::get<1>(handles);
+        }
+    };
+    auto future1 = std::async(std::launch::async, worker, std::ref(m1), std::ref(m2));
+    auto future2 = std::async(std::launch::async, worker, std::ref(m2), std::ref(m1));
+    future1.wait();
+    future2.wait();
+    REQUIRE(*m1.lock() == 2000);
+    REQUIRE(*m2.lock() == 2000);
+}
+
+TEST_CASE("MCS shared mutex readers do not exclude each other", "[mcs_mutex]")
+{
+    Mustex<int, McsSharedMutex> m(42);
+    auto handle = m.lock();
+    auto future = std::async(
+        [&m]
+        {
+            auto handle = m.lock();
+            REQUIRE(*handle == 42);
+            REQUIRE(m.try_lock_for(std::chrono::milliseconds(10)));
+            REQUIRE_FALSE(m.try_lock_mut());
+            REQUIRE_FALSE(m.try_lock_mut_for(std::chrono::milliseconds(10)));
+        }
+    );
+    future.wait();
+    REQUIRE(*handle == 42);
+}
+
+TEST_CASE("MCS shared mutex admits readers after queued writer", "[mcs_mutex]")
+{
+    Mustex<int, McsSharedMutex> m(42);
+    auto opt_handle = m.try_lock();
+    REQUIRE(opt_handle);
+
+    auto writer = std::async(std::launch::async, [&m] { *m.lock_mut() = 8; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    auto reader = std::async(std::launch::async, [&m] { return *m.lock(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    REQUIRE_FALSE(m.try_lock());
+
+    opt_handle = {};
+    writer.wait();
+    REQUIRE(reader.get() == 8);
+}
+
+TEST_CASE("MCS shared mutex under contention", "[mcs_mutex]")
+{
+    Mustex<int, McsSharedMutex> m(0);
+    std::vector<std::future<void>> futures;
+    for (int t = 0; t < 4; ++t)
+    {
+        futures.push_back(std::async(
+            std::launch::async,
+            [&m]
+            {
+                for (int i = 0; i < 1000; ++i)
+                {
+                    if (i % 2 == 0)
+                    {
+                        auto handle = m.lock_mut();
+                        const int value = *handle;
+                        std::this_thread::yield();
+                        *handle = value + 1;
+                    }
+                    else
+                    {
+                        volatile int value = *m.lock();
+                        static_cast<void>(value);
+                    }
+                }
+            }
+        ));
+    }
+    for (auto &future : futures)
+        future.wait();
+    REQUIRE(*m.lock() == 2000);
+}
@@ -0,0 +1,78 @@
+#if CATCH2_VERSION == 2
+#    include <catch2/catch.hpp>
+#else
+#    include <catch2/catch_test_macros.hpp>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mustex/parking_lot_mutex.hpp>
+#include <thread>
+#include <vector>
+
+using namespace bcx;
+
+static_assert(sizeof(ParkingLotMutex) == 1, "ParkingLotMutex must fit in a single byte");
+static_assert(sizeof(Mustex<std::uint32_t, ParkingLotMutex>) == 8, "Mustex<std::uint32_t, ParkingLotMutex> must fit in 8 bytes");
+static_assert(detail::is_timed_lockable<ParkingLotMutex>::value, "ParkingLotMutex must be TimedLockable");
+
+TEST_CASE("Parking lot mutex parked waiters are woken up", "[parking_lot_mutex]")
+{
+    Mustex<int, ParkingLotMutex> m(42);
+    std::atomic<bool> started{false};
+
+    auto future = std::async(
+        [&m, &started]
+        {
+            auto handle = m.lock_mut();
+            started = true;
+            *handle = 8;
+            // Long enough for waiters to give up spinning.
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    );
+    while (!started)
+        ;
+
+    REQUIRE_FALSE(m.try_lock());
+    REQUIRE_FALSE(m.try_lock_mut_for(std::chrono::milliseconds(10)));
+    auto writer = std::async(std::launch::async, [&m] { *m.lock_mut() += 1; });
+    auto opt_handle = m.try_lock_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(1000));
+    REQUIRE(opt_handle);
+    REQUIRE(**opt_handle >= 8);
+    opt_handle = {};
+    writer.wait();
+    REQUIRE(*m.lock() == 9);
+    future.wait();
+}
+
+TEST_CASE("Parking lot mutexes sharing wait queues", "[parking_lot_mutex]")
+{
+    // More mutexes than queues, so that some of them share a queue.
+    std::vector<Mustex<int, ParkingLotMutex>> mutexes(1024);
+    std::vector<std::future<void>> futures;
+    for (int t = 0; t < 4; ++t)
+    {
+        futures.push_back(std::async(
+            std::launch::async,
+            [&mutexes, t]
+            {
+                for (int i = 0; i < 2000; ++i)
+                {
+                    auto handle = mutexes[(i * 7 + t) % 16 * 64].lock_mut();
+                    const int value = *handle;
+                    if (i % 8 == 0)
+                        std::this_thread::yield();
+                    *handle = value + 1;
+                }
+            }
+        ));
+    }
+    for (auto &future : futures)
+        future.wait();
+    int total = 0;
+    for (auto &mutex : mutexes)
+        total += *mutex.lock();
+    REQUIRE(total == 8000);
+}
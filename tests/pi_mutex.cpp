@@ -0,0 +1,136 @@
+#if CATCH2_VERSION == 2
+#    include <catch2/catch.hpp>
+#else
+#    include <catch2/catch_test_macros.hpp>
+#endif
+
+#include <mustex/pi_mutex.hpp>
+
+#ifdef _MUSTEX_HAS_PI_MUTEX
+#    include <pthread.h>
+#    include <sched.h>
+#    include <atomic>
+#    include <chrono>
+#    include <fstream>
+#    include <functional>
+#    include <future>
+#    include <sstream>
+#    include <string>
+#    include <thread>
+#    include <utility>
+
+using namespace bcx;
+
+static_assert(detail::is_timed_lockable<PiMutex>::value, "PiMutex must be TimedLockable");
+
+namespace
+{
+/// @brief Kernel priority of calling thread, negative for real-time ones.
+int this_thread_kernel_priority()
+{
+    std::ifstream file("/proc/thread-self/stat");
+    std::string line;
+    std::getline(file, line);
+    // Fields following the command name, which may contain spaces but ends with ')'.
+    std::istringstream fields(line.substr(line.rfind(')') + 2));
+    std::string field;
+    for (int i = 3; i <= 18 && fields >> field; ++i)
+        ;
+    return std::stoi(field);
+}
+} // namespace
+
+TEST_CASE("Priority inheritance mutex with timed locking", "[pi_mutex]")
+{
+    Mustex<int, PiMutex> m(42);
+    std::atomic<bool> started{false};
+
+    auto future = std::async(
+        std::launch::async,
+        [&m, &started]
+        {
+            auto handle = m.lock_mut();
+            started = true;
+            *handle = 8;
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    );
+    while (!started)
+        ;
+
+    REQUIRE_FALSE(m.try_lock());
+    REQUIRE_FALSE(m.try_lock_mut_for(std::chrono::milliseconds(10)));
+    auto opt_handle = m.try_lock_until(std::chrono::steady_clock::now() + std::chrono::milliseconds(1000));
+    REQUIRE(opt_handle);
+    REQUIRE(**opt_handle == 8);
+    future.wait();
+}
+
+TEST_CASE("Priority inheritance mutex with deadlock avoidance", "[pi_mutex]")
+{
+    Mustex<int, PiMutex> m1(0);
+    Mustex<int, PiMutex> m2(0);
+    auto worker = [](Mustex<int, PiMutex> &first, Mustex<int, PiMutex> &second)
+    {
+        for (int i = 0; i < 1000; ++i)
+        {
+            auto handles = lock_mut(first, second);
+            ++*std::get<0>(handles);
+            ++*std::get<1>(handles);
+        }
+    };
+    auto future1 = std::async(std::launch::async, worker, std::ref(m1), std::ref(m2));
+    auto future2 = std::async(std::launch::async, worker, std::ref(m2), std::ref(m1));
+    future1.wait();
+    future2.wait();
+    REQUIRE(*m1.lock() == 2000);
+    REQUIRE(*m2.lock() == 2000);
+}
+
+TEST_CASE("Priority inheritance mutex boosts holder", "[pi_mutex]")
+{
+    Mustex<int, PiMutex> m(42);
+    std::atomic<bool> locked{false};
+    std::atomic<bool> waiting{false};
+
+    auto holder = std::async(
+        std::launch::async,
+        [&m, &locked, &waiting]
+        {
+            auto handle = m.lock_mut();
+            const int priority = this_thread_kernel_priority();
+            locked = true;
+            while (!waiting)
+                std::this_thread::yield();
+            // Leave some time for the waiter to block on the mutex.
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            return std::make_pair(priority, this_thread_kernel_priority());
+        }
+    );
+    while (!locked)
+        std::this_thread::yield();
+
+    std::thread waiter(
+        [&m, &waiting]
+        {
+            waiting = true;
+            *m.lock_mut() = 8;
+        }
+    );
+    sched_param param{};
+    param.sched_priority = 1;
+    if (pthread_setschedparam(waiter.native_handle(), SCHED_FIFO, &param) != 0)
+    {
+        waiting = true;
+        waiter.join();
+        holder.wait();
+        WARN("Real-time scheduling not permitted, priority boost not checked");
+        return;
+    }
+    const auto priorities = holder.get();
+    waiter.join();
+    REQUIRE(priorities.first >= 0);
+    REQUIRE(priorities.second < 0);
+    REQUIRE(*m.lock() == 8);
+}
+#endif // #ifdef _MUSTEX_HAS_PI_MUTEX
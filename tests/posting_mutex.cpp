@@ -0,0 +1,175 @@
+#if CATCH2_VERSION == 2
+#    include <catch2/catch.hpp>
+#else
+#    include <catch2/catch_test_macros.hpp>
+#endif
+
+#include <atomic>
+#include <future>
+#include <mustex/posting_mutex.hpp>
+#include <mustex/ranked_mutex.hpp>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace bcx;
+
+static_assert(detail::is_posting<WithPosting<std::mutex>>::value, "WithPosting must accept posted mutations");
+static_assert(!detail::is_posting<std::mutex>::value, "std::mutex must not accept posted mutations");
+static_assert(
+    detail::is_posting<Ranked<WithPosting<std::mutex>, 1>>::value,
+    "Mutex wrappers must forward posted mutations"
+);
+static_assert(detail::is_lockable<WithPosting<std::mutex>>::value, "WithPosting<std::mutex> must be Lockable");
+static_assert(
+    detail::is_upgrade_lockable<WithPosting<SharedFutexMutex>>::value,
+    "WithPosting<SharedFutexMutex> must be UpgradeLockable"
+);
+
+TEST_CASE("Posted mutation is applied right away without contention", "[posting_mutex]")
+{
+    Mustex<std::vector<int>, WithPosting<std::mutex>> m;
+
+    m.post([](std::vector<int> &v) { v.push_back(1); });
+    m.post([](std::vector<int> &v) { v.push_back(2); });
+    REQUIRE(*m.lock() == std::vector<int>{1, 2});
+    REQUIRE(m.try_lock_mut());
+}
+
+TEST_CASE("Posted mutation goes through other mutex wrappers", "[posting_mutex]")
+{
+    Mustex<int, Ranked<WithPosting<std::mutex>, 1>> m(1);
+
+    {
+        auto handle = m.lock_mut();
+        m.post([](int &value) { value *= 3; });
+        *handle = 2;
+    }
+    REQUIRE(*m.lock() == 6);
+}
+
+namespace
+{
+/// @brief Number of attempts of an OwnedMutex owner to lock it again.
+int relocks = 0;
+
+/// @brief std::mutex counting attempts of its owner to lock it again, which are undefined behavior.
+class OwnedMutex
+{
+public:
+    void lock()
+    {
+        m_mutex.lock();
+        m_owner.store(std::this_thread::get_id());
+    }
+
+    bool try_lock()
+    {
+        if (m_owner.load() == std::this_thread::get_id())
+        {
+            ++relocks;
+            return false;
+        }
+        if (!m_mutex.try_lock())
+            return false;
+        m_owner.store(std::this_thread::get_id());
+        return true;
+    }
+
+    void unlock()
+    {
+        m_owner.store(std::thread::id());
+        m_mutex.unlock();
+    }
+
+private:
+    std::mutex m_mutex;
+    std::atomic<std::thread::id> m_owner{std::thread::id()};
+};
+} // namespace
+
+TEST_CASE("Posting thread holding the mutex does not lock it again", "[posting_mutex]")
+{
+    Mustex<int, WithPosting<OwnedMutex>> m(1);
+    WithPosting<OwnedMutex> &mutex = detail::MustexAccess::mutex(m);
+
+    relocks = 0;
+    {
+        auto handle = m.lock_mut();
+        REQUIRE(mutex.is_held_by_this_thread());
+        m.post([](int &value) { value *= 3; });
+        *handle = 2;
+    }
+    REQUIRE_FALSE(mutex.is_held_by_this_thread());
+    REQUIRE(*m.lock() == 6);
+    m.post([](int &value) { value += 1; });
+    REQUIRE(*m.lock() == 7);
+    REQUIRE(relocks == 0);
+}
+
+TEST_CASE("Posted mutations are applied in order once the mutex is released", "[posting_mutex]")
+{
+    Mustex<std::vector<int>, WithPosting<SharedFutexMutex>> m;
+
+    {
+        auto handle = m.lock_mut();
+        // Posting never blocks on the held mutex.
+        std::async(std::launch::async, [&m] { m.post([](std::vector<int> &v) { v.push_back(2); }); }).wait();
+        m.post([](std::vector<int> &v) { v.push_back(3); });
+        REQUIRE(handle->empty());
+        handle->push_back(1);
+    }
+    REQUIRE(*m.lock() == std::vector<int>{1, 2, 3});
+
+    {
+        auto handle = m.lock();
+        m.post([](std::vector<int> &v) { v.push_back(4); });
+        REQUIRE(handle->size() == 3);
+    }
+    REQUIRE(m.lock()->size() == 4);
+
+    {
+        auto handle = m.lock_upgradable();
+        m.post([](std::vector<int> &v) { v.push_back(5); });
+        auto handle_mut = std::move(handle).upgrade();
+        // Applied on write access, before the upgraded handle is given.
+        REQUIRE(handle_mut->back() == 5);
+        handle_mut->push_back(6);
+        m.post([](std::vector<int> &v) { v.push_back(7); });
+        auto handle_read = std::move(handle_mut).downgrade();
+        REQUIRE(*handle_read == std::vector<int>{1, 2, 3, 4, 5, 6, 7});
+    }
+}
+
+TEST_CASE("Mutations posted from many threads are all applied", "[posting_mutex]")
+{
+    Mustex<int, WithPosting<SharedFutexMutex>> m(0);
+    std::vector<std::future<void>> futures;
+
+    for (int t = 0; t < 4; ++t)
+        futures.push_back(std::async(
+            std::launch::async,
+            [&m]
+            {
+                for (int i = 0; i < 10000; ++i)
+                    m.post([](int &value) { ++value; });
+            }
+        ));
+    futures.push_back(std::async(
+        std::launch::async,
+        [&m]
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                if (i % 2)
+                    *m.lock_mut() += 2;
+                else
+                    m.lock();
+            }
+        }
+    ));
+    for (std::future<void> &future : futures)
+        future.wait();
+    m.flush();
+    REQUIRE(*m.lock() == 40000 + 1000);
+}
@@ -0,0 +1,225 @@
+#if CATCH2_VERSION == 2
+#    include <catch2/catch.hpp>
+#else
+#    include <catch2/catch_test_macros.hpp>
+#endif
+
+#include <chrono>
+#include <future>
+#include <mustex/posting_mutex.hpp>
+#include <mustex/ranked_mutex.hpp>
+#include <mustex/wait_strategy.hpp>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+using namespace bcx;
+
+static_assert(detail::is_ranked<Ranked<std::mutex, 1>>::value, "Ranked must have a rank");
+static_assert(!detail::is_ranked<std::mutex>::value, "std::mutex must not have a rank");
+static_assert(detail::is_lockable<Ranked<std::mutex, 1>>::value, "Ranked<std::mutex> must be Lockable");
+static_assert(!detail::is_basic_shared_lockable<Ranked<std::mutex, 1>>::value, "Ranked<std::mutex> must not be shared");
+static_assert(
+    detail::is_shared_timed_lockable<Ranked<SharedFutexMutex, 1>>::value,
+    "Ranked<SharedFutexMutex> must be SharedTimedLockable"
+);
+static_assert(detail::is_timed_lockable<Ranked<SharedFutexMutex, 1>>::value, "Ranked<SharedFutexMutex> must be TimedLockable");
+static_assert(
+    detail::is_upgrade_lockable<Ranked<SharedFutexMutex, 1>>::value,
+    "Ranked<SharedFutexMutex> must be UpgradeLockable"
+);
+static_assert(
+    detail::is_ranked<WithPosting<Ranked<std::mutex, 1>>>::value,
+    "Mutex wrappers must forward the rank of the wrapped mutex"
+);
+static_assert(
+    detail::lock_rank<WithWaitStrategy<Ranked<std::mutex, 2>, YieldWait>>::value == 2,
+    "Mutex wrappers must forward the rank of the wrapped mutex"
+);
+
+namespace
+{
+/// @brief Identifiers of the RecordingMutex locked by calling thread, in locking order.
+std::vector<int> &locking_order()
+{
+    static thread_local std::vector<int> order;
+    return order;
+}
+
+template<int ID>
+class RecordingMutex
+{
+public:
+    void lock()
+    {
+        m_mutex.lock();
+        locking_order().push_back(ID);
+    }
+
+    bool try_lock()
+    {
+        if (!m_mutex.try_lock())
+            return false;
+        locking_order().push_back(ID);
+        return true;
+    }
+
+    void unlock() { m_mutex.unlock(); }
+
+private:
+    std::mutex m_mutex;
+};
+} // namespace
+
+TEST_CASE("Ranked Mustex are locked in increasing rank order", "[ranked_mutex]")
+{
+    Mustex<int, Ranked<RecordingMutex<3>, 3>> m3(3);
+    Mustex<int, Ranked<RecordingMutex<1>, 1>> m1(1);
+    Mustex<int, Ranked<RecordingMutex<2>, 2>> m2(2);
+
+    locking_order().clear();
+    {
+        auto handles = lock_mut(m3, m1, m2);
+        REQUIRE(*std::get<0>(handles) == 3);
+        REQUIRE(*std::get<1>(handles) == 1);
+        REQUIRE(*std::get<2>(handles) == 2);
+    }
+    REQUIRE(locking_order() == std::vector<int>{1, 2, 3});
+
+    locking_order().clear();
+    {
+        auto handles = lock(read(m2), write(m3), read(m1));
+        *std::get<1>(handles) = 30;
+    }
+    REQUIRE(locking_order() == std::vector<int>{1, 2, 3});
+    REQUIRE(*m3.lock() == 30);
+}
+
+TEST_CASE("Ranked Mustex can be locked one by one in increasing rank order", "[ranked_mutex]")
+{
+    Mustex<int, Ranked<SharedFutexMutex, 1>> m1(1);
+    Mustex<int, Ranked<SharedFutexMutex, 2>> m2(2);
+    Mustex<int, Ranked<std::mutex, 3>> m3(3);
+
+    for (int i = 0; i < 2; ++i)
+    {
+        auto handle1 = m1.lock();
+        auto handle2 = m2.lock_mut();
+        auto handle3 = m3.lock_mut();
+        *handle2 += *handle1;
+        *handle3 += *handle2;
+    }
+    // Try locks cannot deadlock, and are allowed in any order.
+    {
+        auto handle3 = m3.lock();
+        REQUIRE(m1.try_lock_mut());
+    }
+    REQUIRE(*m2.lock() == 4);
+    REQUIRE(*m3.lock() == 10);
+}
+
+TEST_CASE("Ranked Mustex locked in any argument order avoid deadlocks", "[ranked_mutex]")
+{
+    Mustex<int, Ranked<SharedFutexMutex, 1>> m1(0);
+    Mustex<int, Ranked<SharedFutexMutex, 2>> m2(0);
+    Mustex<int, Ranked<std::mutex, 3>> m3(0);
+
+    auto future1 = std::async(
+        std::launch::async,
+        [&]
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto handles = lock_mut(m1, m2, m3);
+                ++*std::get<0>(handles);
+                ++*std::get<2>(handles);
+            }
+        }
+    );
+    auto future2 = std::async(
+        std::launch::async,
+        [&]
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto handles = lock_mut(m3, m2, m1);
+                ++*std::get<1>(handles);
+                ++*std::get<2>(handles);
+            }
+        }
+    );
+    auto future3 = std::async(
+        std::launch::async,
+        [&]
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto handles = lock(read(m3), write(m2), read(m1));
+                ++*std::get<1>(handles);
+            }
+        }
+    );
+    future1.wait();
+    future2.wait();
+    future3.wait();
+    REQUIRE(*m1.lock() == 2000);
+    REQUIRE(*m2.lock() == 2000);
+    REQUIRE(*m3.lock() == 1000);
+}
+
+TEST_CASE("Ranked Mustex locked with ordered_lock follow rank order", "[ranked_mutex]")
+{
+    Mustex<int, Ranked<RecordingMutex<2>, 2>> m2(2);
+    Mustex<int, Ranked<RecordingMutex<1>, 1>> m1(1);
+    Mustex<int, Ranked<RecordingMutex<3>, 3>> m3(3);
+
+    locking_order().clear();
+    {
+        auto handles = lock_mut(ordered_lock, m2, m1, m3);
+        REQUIRE(*std::get<0>(handles) == 2);
+        REQUIRE(*std::get<1>(handles) == 1);
+        REQUIRE(*std::get<2>(handles) == 3);
+    }
+    REQUIRE(locking_order() == std::vector<int>{1, 2, 3});
+
+    locking_order().clear();
+    {
+        auto handles = lock(ordered_lock, write(m3), read(m2), write(m1));
+        *std::get<0>(handles) = 30;
+    }
+    REQUIRE(locking_order() == std::vector<int>{1, 2, 3});
+    REQUIRE(*m3.lock() == 30);
+}
+
+TEST_CASE("Ranked Mustex of a range can be tried together", "[ranked_mutex]")
+{
+    std::vector<Mustex<int, Ranked<SharedFutexMutex, 1>>> mustexes(4);
+
+    {
+        auto handles = try_lock_mut_range(mustexes.begin(), mustexes.end());
+        REQUIRE(handles);
+        REQUIRE(handles->size() == 4);
+        *(*handles)[2] = 2;
+    }
+    {
+        auto handle = mustexes[1].lock();
+        REQUIRE_FALSE(try_lock_mut_range_for(mustexes.begin(), mustexes.end(), std::chrono::milliseconds(1)));
+    }
+    REQUIRE(try_lock_mut_range_for(mustexes.begin(), mustexes.end(), std::chrono::milliseconds(1)));
+    REQUIRE(*mustexes[2].lock() == 2);
+}
+
+TEST_CASE("Ranked Mustex wrapped in other mutex wrappers keep their rank", "[ranked_mutex]")
+{
+    Mustex<int, WithPosting<Ranked<RecordingMutex<2>, 2>>> m2(2);
+    Mustex<int, WithWaitStrategy<Ranked<RecordingMutex<1>, 1>, YieldWait>> m1(1);
+    Mustex<int, Ranked<RecordingMutex<3>, 3>> m3(3);
+
+    locking_order().clear();
+    {
+        auto handles = lock_mut(m3, m2, m1);
+        *std::get<1>(handles) += *std::get<2>(handles);
+    }
+    REQUIRE(locking_order() == std::vector<int>{1, 2, 3});
+    REQUIRE(*m2.lock() == 3);
+}
@@ -0,0 +1,156 @@
+#if CATCH2_VERSION == 2
+#    include <catch2/catch.hpp>
+#else
+#    include <catch2/catch_test_macros.hpp>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <map>
+#include <mustex/rcu_mustex.hpp>
+#include <string>
+#include <thread>
+
+using namespace bcx;
+
+namespace
+{
+/// Counts its live instances.
+class Tracked
+{
+public:
+    explicit Tracked(int value)
+        : m_value{value}
+    {
+        ++alive;
+    }
+    Tracked(const Tracked &other)
+        : m_value{other.m_value}
+    {
+        ++alive;
+    }
+    ~Tracked() { --alive; }
+
+    int value() const { return m_value; }
+    void set(int value) { m_value = value; }
+
+    static std::atomic<int> alive;
+
+private:
+    int m_value;
+};
+
+std::atomic<int> Tracked::alive{0};
+} // namespace
+
+TEST_CASE("Lock rcu mustex", "[rcu_mustex]")
+{
+    RcuMustex<std::string> m("Batman");
+    auto handle = m.lock();
+    REQUIRE(*handle == "Batman");
+    REQUIRE(handle->size() == 6);
+}
+
+TEST_CASE("Lock rcu mustex mutably", "[rcu_mustex]")
+{
+    RcuMustex<std::map<int, std::string>> m;
+    {
+        auto handle = m.lock_mut();
+        (*handle)[1] = "one";
+    }
+    auto handle = m.lock();
+    REQUIRE(handle->at(1) == "one");
+}
+
+TEST_CASE("Rcu mustex readers keep their version", "[rcu_mustex]")
+{
+    RcuMustex<int> m(42);
+    auto handle = m.lock();
+    {
+        auto handle_mut = m.lock_mut();
+        *handle_mut = 8;
+        // Readers keep seeing the published version while the writer works.
+        REQUIRE(*m.lock() == 42);
+    }
+    REQUIRE(*handle == 42);
+    REQUIRE(*m.lock() == 8);
+}
+
+TEST_CASE("Rcu mustex reclaims replaced versions", "[rcu_mustex]")
+{
+    {
+        RcuMustex<Tracked> m(1);
+        REQUIRE(Tracked::alive == 1);
+        {
+            auto handle = m.lock();
+            m.lock_mut()->set(2);
+            // Replaced version is still used by this thread.
+            REQUIRE(Tracked::alive == 2);
+            REQUIRE(handle->value() == 1);
+        }
+        m.synchronize();
+        REQUIRE(Tracked::alive == 1);
+        REQUIRE(m.lock()->value() == 2);
+    }
+    REQUIRE(Tracked::alive == 0);
+}
+
+TEST_CASE("Try lock rcu mustex mutably", "[rcu_mustex]")
+{
+    RcuMustex<int> m(42);
+    std::atomic<bool> started{false};
+
+    auto future = std::async(
+        [&m, &started]
+        {
+            auto opt_handle = m.try_lock_mut();
+            started = true;
+            REQUIRE(opt_handle);
+            **opt_handle = 45;
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    );
+
+    while (!started)
+        ;
+
+    REQUIRE(m.try_lock());
+    REQUIRE_FALSE(m.lock_mut(std::try_to_lock));
+    REQUIRE_FALSE(m.try_lock_mut_for(std::chrono::milliseconds(10)));
+    auto opt_handle = m.try_lock_mut_for(std::chrono::milliseconds(1000));
+    REQUIRE(opt_handle);
+    REQUIRE(**opt_handle == 45);
+    future.wait();
+}
+
+TEST_CASE("Rcu mustex readers race with writers", "[rcu_mustex]")
+{
+    RcuMustex<std::map<int, int>> m;
+    std::atomic<bool> running{true};
+
+    auto writer = std::async(
+        [&m, &running]
+        {
+            for (int i = 1; i < 1000; ++i)
+            {
+                auto handle = m.lock_mut();
+                (*handle)[i] = 2 * i;
+                handle->erase(i - 1);
+            }
+            running = false;
+        }
+    );
+
+    bool consistent = true;
+    while (running)
+    {
+        auto handle = m.lock();
+        consistent = consistent && handle->size() <= 1;
+        for (const auto &item : *handle)
+            consistent = consistent && item.second == 2 * item.first;
+    }
+    writer.wait();
+    REQUIRE(consistent);
+    REQUIRE(m.lock()->at(999) == 1998);
+}
@@ -0,0 +1,118 @@
+#if CATCH2_VERSION == 2
+#    include <catch2/catch.hpp>
+#else
+#    include <catch2/catch_test_macros.hpp>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mustex/seq_mustex.hpp>
+#include <thread>
+
+using namespace bcx;
+
+namespace
+{
+struct Position
+{
+    int64_t x;
+    int64_t y;
+    int64_t z;
+};
+} // namespace
+
+TEST_CASE("Lock seq mustex", "[seq_mustex]")
+{
+    SeqMustex<int> m(42);
+    auto handle = m.lock();
+    REQUIRE(*handle == 42);
+}
+
+TEST_CASE("Lock seq mustex mutably", "[seq_mustex]")
+{
+    SeqMustex<Position> m(Position{1, 2, 3});
+    {
+        auto handle = m.lock_mut();
+        REQUIRE(handle->x == 1);
+        handle->x = 4;
+        REQUIRE(handle->x == 4);
+    }
+    auto handle = m.lock();
+    REQUIRE(handle->x == 4);
+    REQUIRE(handle->y == 2);
+    REQUIRE(handle->z == 3);
+}
+
+TEST_CASE("Lock seq mustex readonly while locked mutably", "[seq_mustex]")
+{
+    SeqMustex<int> m(42);
+    auto handle_mut = m.lock_mut();
+    *handle_mut = 8;
+
+    // Readers are not blocked by writers, and see the last published value.
+    auto future = std::async(
+        [&m]
+        {
+            auto opt_handle = m.try_lock();
+            REQUIRE(opt_handle);
+            REQUIRE(**opt_handle == 42);
+        }
+    );
+    future.wait();
+}
+
+TEST_CASE("Try lock seq mustex mutably", "[seq_mustex]")
+{
+    SeqMustex<int> m(42);
+    std::atomic<bool> started{false};
+
+    auto future = std::async(
+        [&m, &started]
+        {
+            auto opt_handle = m.try_lock_mut();
+            started = true;
+            REQUIRE(opt_handle);
+            **opt_handle = 45;
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+    );
+
+    while (!started)
+        ;
+
+    REQUIRE_FALSE(m.lock_mut(std::try_to_lock));
+    REQUIRE_FALSE(m.try_lock_mut_for(std::chrono::milliseconds(10)));
+    auto opt_handle = m.try_lock_mut_for(std::chrono::milliseconds(1000));
+    REQUIRE(opt_handle);
+    REQUIRE(**opt_handle == 45);
+    future.wait();
+}
+
+TEST_CASE("Seq mustex readers never see torn data", "[seq_mustex]")
+{
+    SeqMustex<Position> m(Position{0, 0, 0});
+    std::atomic<bool> running{true};
+
+    auto writer = std::async(
+        [&m, &running]
+        {
+            for (int64_t i = 1; i < 10000; ++i)
+            {
+                auto handle = m.lock_mut();
+                *handle = Position{i, 2 * i, 3 * i};
+            }
+            running = false;
+        }
+    );
+
+    bool consistent = true;
+    while (running)
+    {
+        auto handle = m.lock();
+        consistent = consistent && handle->y == 2 * handle->x && handle->z == 3 * handle->x;
+    }
+    writer.wait();
+    REQUIRE(consistent);
+    REQUIRE(m.lock()->x == 9999);
+}
@@ -5,13 +5,28 @@
 #    include <catch2/catch_test_macros.hpp>
 #endif
 
+#include <atomic>
 #include <chrono>
 #include <future>
 #include <mustex/mustex.hpp>
 #include <thread>
+#include <vector>
 
 using namespace bcx;
 
+struct RawMustex
+{
+    int data;
+    std::mutex mutex;
+};
+
+static_assert(sizeof(Mustex<int, std::mutex>) == sizeof(RawMustex), "Mustex must be as small as its data and mutex");
+static_assert(sizeof(Mustex<int>::Handle) == sizeof(void *), "Handle must be a single pointer");
+static_assert(sizeof(Mustex<int>::HandleMut) == sizeof(void *), "HandleMut must be a single pointer");
+static_assert(!std::is_polymorphic<Mustex<int>>::value, "Mustex must not have a vtable");
+static_assert(!std::is_polymorphic<Mustex<int>::HandleMut>::value, "HandleMut must not have a vtable");
+static_assert(sizeof(decltype(std::declval<Mustex<int> &>().try_lock_mut())) == 2 * sizeof(void *), "Try lock results must hold the handle inline");
+
 class BasicLockable
 {
 public:
@@ -63,6 +78,18 @@ TEST_CASE("Lock mustex", "[mustex]")
     REQUIRE(*handle == 42);
 }
 
+TEST_CASE("Lock mustex of const data", "[mustex]")
+{
+    Mustex<const int> m(42);
+    {
+        auto handle = m.lock();
+        REQUIRE(*handle == 42);
+    }
+    auto handle = m.try_lock();
+    REQUIRE(handle);
+    REQUIRE(**handle == 42);
+}
+
 TEST_CASE("Lock mustex mutably", "[mustex]")
 {
     Mustex<int> m(42);
@@ -314,6 +341,32 @@ TEST_CASE("Try lock", "[mustex]")
     future2.wait();
 }
 
+TEST_CASE("Try lock results keep the lock until dropped", "[mustex]")
+{
+    Mustex<int, SharedFutexMutex> m(42);
+    {
+        auto opt_handle = m.try_lock_mut();
+        REQUIRE(opt_handle);
+        auto moved = std::move(opt_handle);
+        REQUIRE(moved);
+        REQUIRE(**moved == 42);
+        REQUIRE_FALSE(m.try_lock());
+        moved.reset();
+        REQUIRE_FALSE(moved);
+        REQUIRE(m.try_lock());
+    }
+    {
+        auto opt_handle = m.try_lock();
+        auto other = m.try_lock();
+        other.reset();
+        other = std::move(opt_handle);
+        REQUIRE(other);
+        REQUIRE(**other == 42);
+        REQUIRE_FALSE(m.try_lock_mut());
+    }
+    REQUIRE(m.try_lock_mut());
+}
+
 TEST_CASE("Try lock mutably for", "[mustex]")
 {
     Mustex<int> m(42);
@@ -969,6 +1022,287 @@ TEST_CASE("Synchronous try lock", "[mustex]")
     }
 }
 
+TEST_CASE("Synchronous mixed lock", "[mustex]")
+{
+    Mustex<int, SharedFutexMutex> shared1(1);
+    Mustex<float, SharedFutexMutex> shared2(2.f);
+
+    auto handles = lock(read(shared1), write(shared2));
+#if defined(__cplusplus) && __cplusplus >= 201703L
+    auto &[handle1, handle2] = handles;
+#else // #if defined(__cplusplus) && __cplusplus >= 201703L
+    auto &handle1 = std::get<0>(handles);
+    auto &handle2 = std::get<1>(handles);
+#endif // #if defined(__cplusplus) && __cplusplus >= 201703L
+    *handle2 += static_cast<float>(*handle1);
+    REQUIRE(*handle2 == 3.f);
+
+    auto future = std::async(
+        std::launch::async,
+        [&shared1, &shared2]
+        {
+            // Readers of the first one are let in, but nobody else.
+            REQUIRE(shared1.try_lock());
+            REQUIRE_FALSE(shared1.try_lock_mut());
+            REQUIRE_FALSE(shared2.try_lock());
+        }
+    );
+    future.wait();
+}
+
+TEST_CASE("Synchronous mixed lock avoids deadlocks", "[mustex]")
+{
+    Mustex<int, SharedFutexMutex> shared1(0);
+    Mustex<int, SharedFutexMutex> shared2(0);
+
+    auto future1 = std::async(
+        std::launch::async,
+        [&shared1, &shared2]
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto handles = lock(read(shared1), write(shared2));
+                ++*std::get<1>(handles);
+            }
+        }
+    );
+    auto future2 = std::async(
+        std::launch::async,
+        [&shared1, &shared2]
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto handles = lock(read(shared2), write(shared1));
+                ++*std::get<1>(handles);
+            }
+        }
+    );
+    future1.wait();
+    future2.wait();
+    REQUIRE(*shared1.lock() == 1000);
+    REQUIRE(*shared2.lock() == 1000);
+}
+
+TEST_CASE("Ordered lock avoids deadlocks", "[mustex]")
+{
+    Mustex<int> shared1(0);
+    Mustex<int> shared2(0);
+    Mustex<int> shared3(0);
+    std::mutex m;
+
+    auto future1 = std::async(
+        std::launch::async,
+        [&]
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto locks = lock_mut(ordered_lock, shared1, shared2, shared3, m);
+                ++*std::get<0>(locks);
+                REQUIRE(std::get<3>(locks).owns_lock());
+            }
+        }
+    );
+    auto future2 = std::async(
+        std::launch::async,
+        [&]
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto locks = lock_mut(ordered_lock, m, shared3, shared2, shared1);
+                ++*std::get<1>(locks);
+            }
+        }
+    );
+    auto future3 = std::async(
+        std::launch::async,
+        [&]
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto handles = lock(ordered_lock, read(shared3), write(shared2), read(shared1));
+                ++*std::get<1>(handles);
+            }
+        }
+    );
+    future1.wait();
+    future2.wait();
+    future3.wait();
+    REQUIRE(*shared1.lock() == 1000);
+    REQUIRE(*shared2.lock() == 1000);
+    REQUIRE(*shared3.lock() == 1000);
+}
+
+TEST_CASE("Synchronous mixed try lock", "[mustex]")
+{
+    Mustex<int, SharedFutexMutex> shared1(1);
+    Mustex<float, SharedFutexMutex> shared2(2.f);
+
+    {
+        auto handles = try_lock(read(shared1), write(shared2));
+        REQUIRE(handles);
+        REQUIRE(*std::get<0>(*handles) == 1);
+        REQUIRE(*std::get<1>(*handles) == 2.f);
+    }
+    {
+        // Readers do not prevent from reading.
+        auto handle = shared1.lock();
+        REQUIRE(try_lock(read(shared1), write(shared2)));
+        REQUIRE_FALSE(try_lock(write(shared1), write(shared2)));
+    }
+    {
+        auto handle = shared2.lock();
+        REQUIRE_FALSE(try_lock(read(shared1), write(shared2)));
+        REQUIRE(try_lock(read(shared1), read(shared2)));
+    }
+}
+
+TEST_CASE("Synchronous timed multi lock", "[mustex]")
+{
+    Mustex<int, SharedFutexMutex> shared1(1);
+    Mustex<float, SharedFutexMutex> shared2(2.f);
+    std::timed_mutex m;
+
+    {
+        auto res = try_lock_mut_for(std::chrono::milliseconds(10), shared1, shared2, m);
+        REQUIRE(res);
+        REQUIRE(*std::get<0>(*res) == 1);
+        REQUIRE(*std::get<1>(*res) == 2.f);
+        REQUIRE(std::get<2>(*res).owns_lock());
+    }
+    {
+        auto handle = shared2.lock();
+        REQUIRE_FALSE(try_lock_mut_for(std::chrono::milliseconds(10), shared1, shared2, m));
+        REQUIRE_FALSE(try_lock_mut_until(std::chrono::steady_clock::now(), m, shared2));
+        // Nothing stays locked on failure.
+        REQUIRE(shared1.try_lock_mut());
+        REQUIRE(m.try_lock());
+        m.unlock();
+    }
+    {
+        auto handle = shared1.try_lock_mut();
+        REQUIRE(handle);
+        auto future = std::async(
+            std::launch::async,
+            [&] { return try_lock_mut_for(std::chrono::seconds(10), shared2, shared1).has_value(); }
+        );
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        **handle = 3;
+        handle.reset();
+        REQUIRE(future.get());
+        REQUIRE(*shared1.lock() == 3);
+    }
+}
+
+TEST_CASE("Timed multi lock avoids deadlocks", "[mustex]")
+{
+    Mustex<int, SharedFutexMutex> shared1(0);
+    Mustex<int, SharedFutexMutex> shared2(0);
+    Mustex<int, SharedFutexMutex> shared3(0);
+
+    auto future1 = std::async(
+        std::launch::async,
+        [&]
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto res = try_lock_mut_for(std::chrono::seconds(10), shared1, shared2, shared3);
+                REQUIRE(res);
+                ++*std::get<0>(*res);
+            }
+        }
+    );
+    auto future2 = std::async(
+        std::launch::async,
+        [&]
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto res = try_lock_mut_until(std::chrono::steady_clock::now() + std::chrono::seconds(10), shared3, shared2, shared1);
+                REQUIRE(res);
+                ++*std::get<2>(*res);
+            }
+        }
+    );
+    future1.wait();
+    future2.wait();
+    REQUIRE(*shared1.lock() == 2000);
+}
+
+TEST_CASE("Synchronous range lock", "[mustex]")
+{
+    std::vector<Mustex<int, SharedFutexMutex>> accounts(20);
+    for (std::size_t i = 0; i < accounts.size(); ++i)
+        *accounts[i].lock_mut() = static_cast<int>(i);
+
+    {
+        auto handles = lock_mut_range(accounts.begin(), accounts.begin() + 3);
+        REQUIRE(handles.size() == 3);
+        for (std::size_t i = 0; i < handles.size(); ++i)
+            REQUIRE(*handles[i] == static_cast<int>(i));
+        REQUIRE_FALSE(accounts[1].try_lock());
+        REQUIRE(accounts[3].try_lock());
+    }
+    {
+        // Beyond inline capacity, and moved around.
+        auto handles = lock_mut_range(accounts.begin(), accounts.end());
+        auto moved = std::move(handles);
+        REQUIRE(handles.empty());
+        REQUIRE(moved.size() == accounts.size());
+        REQUIRE(*moved[19] == 19);
+        REQUIRE_FALSE(accounts[19].try_lock());
+    }
+    {
+        std::vector<Mustex<int, SharedFutexMutex> *> selected{&accounts[7], &accounts[2], &accounts[5]};
+        auto handles = try_lock_mut_range(selected.begin(), selected.end());
+        REQUIRE(handles);
+        REQUIRE(*(*handles)[0] == 7);
+        REQUIRE(*(*handles)[1] == 2);
+        REQUIRE(*(*handles)[2] == 5);
+    }
+    {
+        auto handle = accounts[5].lock();
+        REQUIRE_FALSE(try_lock_mut_range(accounts.begin(), accounts.end()));
+        REQUIRE_FALSE(try_lock_mut_range_for(accounts.begin(), accounts.end(), std::chrono::milliseconds(10)));
+        REQUIRE(try_lock_mut_range(accounts.begin(), accounts.begin() + 5));
+        // Nothing stays locked on failure.
+        for (std::size_t i = 0; i < accounts.size(); ++i)
+            REQUIRE(accounts[i].try_lock());
+    }
+    REQUIRE(try_lock_mut_range_until(accounts.begin(), accounts.end(), std::chrono::steady_clock::now()));
+    REQUIRE(lock_mut_range(accounts.end(), accounts.end()).empty());
+}
+
+TEST_CASE("Range lock avoids deadlocks", "[mustex]")
+{
+    std::vector<Mustex<int>> accounts(4);
+    std::vector<Mustex<int> *> reversed{&accounts[3], &accounts[2], &accounts[1], &accounts[0]};
+
+    auto future1 = std::async(
+        std::launch::async,
+        [&]
+        {
+            for (int i = 0; i < 1000; ++i)
+                for (auto &handle : lock_mut_range(accounts.begin(), accounts.end()))
+                    ++*handle;
+        }
+    );
+    auto future2 = std::async(
+        std::launch::async,
+        [&]
+        {
+            for (int i = 0; i < 1000; ++i)
+            {
+                auto handles = lock_mut_range(reversed.begin(), reversed.end());
+                ++*handles[0];
+            }
+        }
+    );
+    future1.wait();
+    future2.wait();
+    REQUIRE(*accounts[0].lock() == 1000);
+    REQUIRE(*accounts[3].lock() == 2000);
+}
+
 TEST_CASE("Mustex with BasicLockable only", "[mustex]")
 {
     Mustex<float, BasicLockable> m(2.f);
@@ -989,4 +1323,306 @@ TEST_CASE("Mustex with Lockable only", "[mustex]")
         auto handle = m.try_lock();
         REQUIRE(handle);
     }
-}
\ No newline at end of file
+}
+static_assert(sizeof(SharedFutexMutex) == 4, "SharedFutexMutex must fit in a single word");
+static_assert(detail::is_shared_timed_lockable<SharedFutexMutex>::value, "SharedFutexMutex must be SharedTimedLockable");
+
+TEST_CASE("Shared futex mutex readers do not exclude each other", "[shared_futex_mutex]")
+{
+    Mustex<int, SharedFutexMutex> m(42);
+    auto handle = m.lock();
+    auto future = std::async(
+        [&m]
+        {
+            auto handle = m.lock();
+            REQUIRE(*handle == 42);
+            REQUIRE(m.try_lock_for(std::chrono::milliseconds(10)));
+            REQUIRE_FALSE(m.try_lock_mut());
+        }
+    );
+    future.wait();
+    REQUIRE(*handle == 42);
+}
+
+TEST_CASE("Shared futex mutex refuses readers past saturated count", "[shared_futex_mutex]")
+{
+    SharedFutexMutex mutex;
+    std::size_t readers = 0;
+    while (mutex.try_lock_shared())
+        ++readers;
+    REQUIRE(readers == 65535);
+    REQUIRE_FALSE(mutex.try_lock_shared());
+    REQUIRE_FALSE(mutex.try_lock_upgrade());
+    REQUIRE_FALSE(mutex.try_lock());
+    REQUIRE_FALSE(mutex.try_lock_shared_for(std::chrono::milliseconds(10)));
+    mutex.unlock_shared();
+    REQUIRE(mutex.try_lock_shared());
+    for (; readers > 0; --readers)
+        mutex.unlock_shared();
+    REQUIRE(mutex.try_lock());
+    mutex.unlock();
+}
+
+TEST_CASE("Shared futex mutex waiting writer holds new readers back", "[shared_futex_mutex]")
+{
+    Mustex<int, SharedFutexMutex> m(42);
+    std::atomic<bool> written{false};
+    auto opt_handle = m.try_lock();
+    REQUIRE(opt_handle);
+
+    auto writer = std::async(
+        std::launch::async,
+        [&m, &written]
+        {
+            *m.lock_mut() = 8;
+            written = true;
+        }
+    );
+    // Once the writer waits, readers cannot come in anymore.
+    auto tic = std::chrono::steady_clock::now();
+    while (m.try_lock() && std::chrono::steady_clock::now() - tic < std::chrono::seconds(1))
+        std::this_thread::yield();
+    REQUIRE_FALSE(m.try_lock());
+    REQUIRE_FALSE(written);
+
+    opt_handle = {};
+    writer.wait();
+    REQUIRE(written);
+    REQUIRE(*m.lock() == 8);
+}
+
+TEST_CASE("Shared futex mutex writer timing out lets readers in", "[shared_futex_mutex]")
+{
+    Mustex<int, SharedFutexMutex> m(42);
+    auto opt_handle = m.try_lock();
+    REQUIRE(opt_handle);
+
+    auto future = std::async(std::launch::async, [&m] { return static_cast<bool>(m.try_lock_mut_for(std::chrono::milliseconds(50))); });
+    REQUIRE_FALSE(future.get());
+    REQUIRE(m.try_lock());
+    opt_handle = {};
+    REQUIRE(m.try_lock_mut());
+}
+
+namespace
+{
+template<SharedLockPolicy P>
+void require_consistent_under_contention()
+{
+    Mustex<int, BasicSharedFutexMutex<P>> m(0);
+    std::vector<std::future<void>> futures;
+    for (int t = 0; t < 4; ++t)
+    {
+        futures.push_back(std::async(
+            std::launch::async,
+            [&m]
+            {
+                for (int i = 0; i < 1000; ++i)
+                {
+                    if (i % 2 == 0)
+                    {
+                        auto handle = m.lock_mut();
+                        const int value = *handle;
+                        std::this_thread::yield();
+                        *handle = value + 1;
+                    }
+                    else
+                    {
+                        volatile int value = *m.lock();
+                        static_cast<void>(value);
+                    }
+                }
+            }
+        ));
+    }
+    for (auto &future : futures)
+        future.wait();
+    REQUIRE(*m.lock() == 2000);
+}
+} // namespace
+
+TEST_CASE("Shared futex mutex under contention", "[shared_futex_mutex]")
+{
+    require_consistent_under_contention<SharedLockPolicy::PreferReaders>();
+    require_consistent_under_contention<SharedLockPolicy::PreferWriters>();
+    require_consistent_under_contention<SharedLockPolicy::PhaseFair>();
+}
+
+TEST_CASE("Shared futex mutex preferring readers lets readers in past waiting writer", "[shared_futex_mutex]")
+{
+    Mustex<int, BasicSharedFutexMutex<SharedLockPolicy::PreferReaders>> m(42);
+    auto opt_handle = m.try_lock();
+    REQUIRE(opt_handle);
+
+    auto writer = std::async(std::launch::async, [&m] { *m.lock_mut() = 8; });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    auto other_handle = m.try_lock();
+    REQUIRE(other_handle);
+    REQUIRE(**other_handle == 42);
+
+    opt_handle = {};
+    other_handle = {};
+    writer.wait();
+    REQUIRE(*m.lock() == 8);
+}
+
+TEST_CASE("Phase fair shared futex mutex lets waiting readers in before next writer", "[shared_futex_mutex]")
+{
+    Mustex<std::vector<int>, BasicSharedFutexMutex<SharedLockPolicy::PhaseFair>> m;
+    std::future<void> writer;
+    std::future<std::size_t> reader;
+    {
+        auto handle = m.lock_mut();
+        writer = std::async(std::launch::async, [&m] { m.lock_mut()->push_back(1); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        reader = std::async(std::launch::async, [&m] { return m.lock()->size(); });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        handle->push_back(0);
+    }
+
+    // The reader came after the writer, but was waiting when the mutex was unlocked.
+    REQUIRE(reader.get() == 1);
+    writer.wait();
+    REQUIRE(*m.lock() == std::vector<int>{0, 1});
+}
+
+static_assert(detail::is_upgrade_lockable<SharedFutexMutex>::value, "SharedFutexMutex must be UpgradeLockable");
+static_assert(detail::is_downgradable<SharedFutexMutex>::value, "SharedFutexMutex must be Downgradable");
+
+TEST_CASE("Upgradable handle excludes writers and upgraders only", "[upgradable]")
+{
+    Mustex<int, SharedFutexMutex> m(42);
+    auto handle = m.lock_upgradable();
+    REQUIRE(*handle == 42);
+    REQUIRE(m.try_lock());
+    REQUIRE_FALSE(m.try_lock_mut());
+    REQUIRE_FALSE(m.try_lock_upgradable());
+}
+
+TEST_CASE("Upgradable handle with exclusive mutex", "[upgradable]")
+{
+    Mustex<int, std::mutex> m(42);
+    {
+        auto handle = m.lock_upgradable();
+        auto handle_mut = std::move(handle).upgrade();
+        *handle_mut = 8;
+        auto handle_read = std::move(handle_mut).downgrade();
+        REQUIRE(*handle_read == 8);
+    }
+    REQUIRE(m.try_lock_upgradable());
+}
+
+TEST_CASE("Upgrade waits for readers and lets no writer in between", "[upgradable]")
+{
+    Mustex<int, SharedFutexMutex> m(0);
+    std::atomic<bool> upgradable{false};
+    std::future<int> upgrader;
+    std::future<void> writer;
+    {
+        auto handle = m.lock();
+        upgrader = std::async(
+            std::launch::async,
+            [&m, &upgradable]
+            {
+                auto handle = m.lock_upgradable();
+                const int seen = *handle;
+                upgradable = true;
+                auto handle_mut = std::move(handle).upgrade();
+                const int value = *handle_mut;
+                *handle_mut = seen + 1;
+                return value;
+            }
+        );
+        while (!upgradable)
+            std::this_thread::yield();
+        writer = std::async(std::launch::async, [&m] { *m.lock_mut() += 100; });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        REQUIRE(upgrader.wait_for(std::chrono::milliseconds(0)) == std::future_status::timeout);
+    }
+
+    // The writer could only come in once the upgrader was done.
+    REQUIRE(upgrader.get() == 0);
+    writer.wait();
+    REQUIRE(*m.lock() == 101);
+}
+
+TEST_CASE("Downgrade lets readers in but no writer", "[upgradable]")
+{
+    Mustex<int, SharedFutexMutex> m(42);
+    {
+        auto handle_mut = m.lock_mut();
+        *handle_mut = 8;
+        auto handle = std::move(handle_mut).downgrade();
+        REQUIRE(*handle == 8);
+        REQUIRE(m.try_lock());
+        REQUIRE_FALSE(m.try_lock_mut());
+    }
+    {
+        auto handle_mut = m.lock_mut();
+        auto writer = std::async(std::launch::async, [&m] { *m.lock_mut() = 16; });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        auto handle = std::move(handle_mut).downgrade();
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        REQUIRE(*handle == 8);
+        REQUIRE(writer.wait_for(std::chrono::milliseconds(0)) == std::future_status::timeout);
+    }
+    REQUIRE(*m.lock() == 16);
+}
+
+namespace
+{
+template<SharedLockPolicy P>
+void require_upgrades_consistent_under_contention()
+{
+    Mustex<int, BasicSharedFutexMutex<P>> m(0);
+    std::atomic<int> lost_updates{0};
+    std::vector<std::future<void>> futures;
+    for (int t = 0; t < 4; ++t)
+    {
+        futures.push_back(std::async(
+            std::launch::async,
+            [&m, &lost_updates]
+            {
+                for (int i = 0; i < 900; ++i)
+                {
+                    if (i % 3 == 0)
+                    {
+                        auto handle = m.lock_upgradable();
+                        const int value = *handle;
+                        std::this_thread::yield();
+                        auto handle_mut = std::move(handle).upgrade();
+                        if (*handle_mut != value)
+                            ++lost_updates;
+                        *handle_mut = value + 1;
+                    }
+                    else if (i % 3 == 1)
+                    {
+                        auto handle_mut = m.lock_mut();
+                        const int value = ++*handle_mut;
+                        auto handle = std::move(handle_mut).downgrade();
+                        std::this_thread::yield();
+                        if (*handle != value)
+                            ++lost_updates;
+                    }
+                    else
+                    {
+                        volatile int value = *m.lock();
+                        static_cast<void>(value);
+                    }
+                }
+            }
+        ));
+    }
+    for (auto &future : futures)
+        future.wait();
+    REQUIRE(lost_updates == 0);
+    REQUIRE(*m.lock() == 2400);
+}
+} // namespace
+
+TEST_CASE("Upgrades and downgrades under contention", "[upgradable]")
+{
+    require_upgrades_consistent_under_contention<SharedLockPolicy::PreferReaders>();
+    require_upgrades_consistent_under_contention<SharedLockPolicy::PreferWriters>();
+    require_upgrades_consistent_under_contention<SharedLockPolicy::PhaseFair>();
+}
@@ -0,0 +1,137 @@
+#if CATCH2_VERSION == 2
+#    include <catch2/catch.hpp>
+#else
+#    include <catch2/catch_test_macros.hpp>
+#endif
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <mustex/wait_strategy.hpp>
+#include <mutex>
+#include <thread>
+
+using namespace bcx;
+
+static_assert(
+    detail::is_lockable<WithWaitStrategy<std::mutex, YieldWait>>::value,
+    "WithWaitStrategy<std::mutex> must be Lockable"
+);
+static_assert(
+    !detail::is_basic_shared_lockable<WithWaitStrategy<std::mutex, YieldWait>>::value,
+    "WithWaitStrategy<std::mutex> must not be shared"
+);
+static_assert(
+    detail::is_shared_timed_lockable<WithWaitStrategy<SharedFutexMutex, SpinWait>>::value,
+    "WithWaitStrategy<SharedFutexMutex> must be SharedTimedLockable"
+);
+static_assert(
+    detail::is_upgrade_lockable<WithWaitStrategy<SharedFutexMutex, SpinWait>>::value,
+    "WithWaitStrategy<SharedFutexMutex> must be UpgradeLockable"
+);
+
+namespace
+{
+/// @brief Wait strategy counting its calls, and parking after given number of attempts.
+template<std::size_t ATTEMPTS>
+struct CountingWait
+{
+    static std::atomic<std::size_t> calls;
+
+    static bool wait(std::size_t attempt)
+    {
+        ++calls;
+        std::this_thread::yield();
+        return attempt + 1 < ATTEMPTS;
+    }
+};
+
+template<std::size_t ATTEMPTS>
+std::atomic<std::size_t> CountingWait<ATTEMPTS>::calls{0};
+} // namespace
+
+TEST_CASE("Wait strategy is not consulted without contention", "[wait_strategy]")
+{
+    Mustex<int, WithWaitStrategy<SharedFutexMutex, CountingWait<1000>>> m(1);
+
+    CountingWait<1000>::calls = 0;
+    ++*m.lock_mut();
+    REQUIRE(*m.lock() == 2);
+    {
+        auto handle = m.lock_upgradable();
+        ++*std::move(handle).upgrade();
+    }
+    REQUIRE(*m.lock() == 3);
+    REQUIRE(CountingWait<1000>::calls == 0);
+}
+
+TEST_CASE("Wait strategy is consulted while the mutex is contended", "[wait_strategy]")
+{
+    Mustex<int, WithWaitStrategy<SharedFutexMutex, CountingWait<1000000>>> m(1);
+
+    CountingWait<1000000>::calls = 0;
+    auto handle = m.try_lock_mut();
+    REQUIRE(handle);
+    auto writer = std::async(std::launch::async, [&m] { ++*m.lock_mut(); });
+    auto reader = std::async(std::launch::async, [&m] { return *m.lock(); });
+    while (CountingWait<1000000>::calls < 10)
+        std::this_thread::yield();
+    **handle = 10;
+    handle.reset();
+    writer.wait();
+    REQUIRE(reader.get() >= 10);
+    REQUIRE(*m.lock() == 11);
+}
+
+TEST_CASE("Wait strategy parks the thread once it gives up", "[wait_strategy]")
+{
+    Mustex<int, WithWaitStrategy<std::mutex, CountingWait<3>>> m(1);
+
+    CountingWait<3>::calls = 0;
+    std::future<void> writer;
+    {
+        auto handle = m.lock_mut();
+        writer = std::async(std::launch::async, [&m] { ++*m.lock_mut(); });
+        while (CountingWait<3>::calls < 3)
+            std::this_thread::yield();
+        *handle = 10;
+    }
+    writer.wait();
+    REQUIRE(CountingWait<3>::calls == 3);
+    REQUIRE(*m.lock() == 11);
+}
+
+TEST_CASE("Callback wait strategy runs other work while the mutex is contended", "[wait_strategy]")
+{
+    Mustex<int, WithWaitStrategy<std::mutex, CallbackWait>> m(1);
+    auto handle = m.try_lock_mut();
+    REQUIRE(handle);
+
+    auto worker = std::async(
+        std::launch::async,
+        [&m]
+        {
+            int tasks = 0;
+            CallbackWait::set_this_thread(
+                [&tasks]
+                {
+                    ++tasks;
+                    std::this_thread::yield();
+                    return true;
+                }
+            );
+            ++*m.lock_mut();
+            CallbackWait::set_this_thread({});
+            return tasks;
+        }
+    );
+    REQUIRE(worker.wait_for(std::chrono::milliseconds(50)) == std::future_status::timeout);
+    handle.reset();
+    REQUIRE(worker.get() > 0);
+    REQUIRE(*m.lock() == 2);
+
+    // Without a callback, the thread parks right away.
+    REQUIRE_FALSE(CallbackWait::wait(0));
+    ++*m.lock_mut();
+    REQUIRE(*m.lock() == 3);
+}